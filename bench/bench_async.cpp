@@ -0,0 +1,72 @@
+#include <future>
+
+#include <benchmark/benchmark.h>
+#include <opex/async.h>
+
+namespace {
+    using result_type = opex::result<int>;
+    using async_type = opex::async_result<int>;
+
+    int step(int v) {
+        return v * 3 + 1;
+    }
+
+    // Status quo: every stage hops to the pool and the caller blocks on a std::future before unwrapping.
+    void StdFutureBlocking(benchmark::State &state) {
+        opex::thread_pool pool{2};
+        const auto stages = state.range(0);
+
+        for (auto _ : state) {
+            int v = 1;
+            for (long s = 0; s < stages; ++s) {
+                std::promise<result_type> p;
+                auto f = p.get_future();
+                pool.submit([&p, v] { p.set_value(result_type::call([v] { return step(v); })); });
+                v = f.get().unwrap();
+            }
+            benchmark::DoNotOptimize(v);
+        }
+    }
+
+    void AsyncChainExecutor(benchmark::State &state) {
+        opex::thread_pool pool{2};
+        const auto stages = state.range(0);
+
+        for (auto _ : state) {
+            auto chain = opex::async(pool, [] { return step(1); });
+            for (long s = 1; s < stages; ++s)
+                chain = std::move(chain).map(step, pool);
+            benchmark::DoNotOptimize(std::move(chain).get().unwrap());
+        }
+    }
+
+    void AsyncChainInline(benchmark::State &state) {
+        opex::thread_pool pool{2};
+        const auto stages = state.range(0);
+
+        for (auto _ : state) {
+            auto chain = opex::async(pool, [] { return step(1); });
+            for (long s = 1; s < stages; ++s)
+                chain = std::move(chain).map(step);
+            benchmark::DoNotOptimize(std::move(chain).get().unwrap());
+        }
+    }
+
+    void PromiseChainInline(benchmark::State &state) {
+        const auto stages = state.range(0);
+
+        for (auto _ : state) {
+            opex::promise<int> p;
+            auto chain = p.get_async_result();
+            for (long s = 0; s < stages; ++s)
+                chain = std::move(chain).map(step);
+            p.set_value(1);
+            benchmark::DoNotOptimize(std::move(chain).get().unwrap());
+        }
+    }
+}
+
+BENCHMARK(StdFutureBlocking)->Arg(1)->Arg(3)->Arg(6)->UseRealTime();
+BENCHMARK(AsyncChainExecutor)->Arg(1)->Arg(3)->Arg(6)->UseRealTime();
+BENCHMARK(AsyncChainInline)->Arg(1)->Arg(3)->Arg(6)->UseRealTime();
+BENCHMARK(PromiseChainInline)->Arg(1)->Arg(3)->Arg(6);
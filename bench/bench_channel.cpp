@@ -0,0 +1,90 @@
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+#include <opex/channel.h>
+
+namespace {
+    using result_type = opex::result<long>;
+
+    constexpr long items = 1 << 16;
+
+    class MutexQueue {
+    public:
+        void push(result_type &&r) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_items.push_back(std::move(r));
+            }
+            m_ready.notify_one();
+        }
+
+        template<typename Func>
+        void pop(Func &&consumer) {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_ready.wait(lock, [this] { return !m_items.empty(); });
+            auto r = std::move(m_items.front());
+            m_items.pop_front();
+            lock.unlock();
+            consumer(std::move(r));
+        }
+
+    private:
+        std::mutex m_mutex;
+        std::condition_variable m_ready;
+        std::deque<result_type> m_items;
+    };
+
+    // Error rate is given in percent; errors are copies of one interned error.
+    result_type make_item(long i, long error_rate, const result_type &error) {
+        return i % 100 < error_rate ? error.map([](long v) { return v; }) : result_type{i};
+    }
+
+    void MutexCondvarQueue(benchmark::State &state) {
+        const auto error = result_type::make_exception<std::runtime_error>("failed");
+        for (auto _ : state) {
+            MutexQueue queue;
+            std::thread producer([&] {
+                for (long i = 0; i < items; ++i)
+                    queue.push(make_item(i, state.range(0), error));
+            });
+
+            long sum = 0;
+            for (long i = 0; i < items; ++i)
+                queue.pop([&](result_type &&r) { sum += r ? *r : -1; });
+            producer.join();
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * items);
+    }
+
+    void ResultChannel(benchmark::State &state) {
+        const auto error = result_type::make_exception<std::runtime_error>("failed");
+        for (auto _ : state) {
+            opex::result_channel<long> channel{1024};
+            std::thread producer([&] {
+                for (long i = 0; i < items; ++i) {
+                    auto item = make_item(i, state.range(0), error);
+                    while (!channel.try_push(std::move(item)))
+                        std::this_thread::yield();
+                }
+                channel.close();
+            });
+
+            long sum = 0;
+            while (!channel.finished()) {
+                if (!channel.try_pop_batch([&](result_type &&r) { sum += r ? *r : -1; }, 64))
+                    std::this_thread::yield();
+            }
+            producer.join();
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * items);
+    }
+}
+
+BENCHMARK(MutexCondvarQueue)->Arg(0)->Arg(1)->Arg(10)->Arg(50)->UseRealTime();
+BENCHMARK(ResultChannel)->Arg(0)->Arg(1)->Arg(10)->Arg(50)->UseRealTime();
@@ -0,0 +1,44 @@
+#include <stdexcept>
+
+#include <benchmark/benchmark.h>
+#include <opex/opex.h>
+
+namespace {
+    template<typename ResultType>
+    ResultType make_error() {
+        return ResultType::template make_exception<std::runtime_error>("interned");
+    }
+
+    const opex::result<int> &interned_error() {
+        static const auto error = make_error<opex::result<int>>();
+        return error;
+    }
+
+    void SharedErrorForward(benchmark::State &state) {
+        const auto &error = interned_error();
+        for (auto _ : state) {
+            auto forwarded = error.map([](int i) { return i + 1; });
+            benchmark::DoNotOptimize(forwarded);
+        }
+    }
+
+    void SharedErrorPerThread(benchmark::State &state) {
+        const auto error = make_error<opex::result<int>>();
+        for (auto _ : state) {
+            auto forwarded = error.map([](int i) { return i + 1; });
+            benchmark::DoNotOptimize(forwarded);
+        }
+    }
+
+    void ConfinedErrorForward(benchmark::State &state) {
+        const auto error = make_error<opex::confined_result<int>>();
+        for (auto _ : state) {
+            auto forwarded = error.map([](int i) { return i + 1; });
+            benchmark::DoNotOptimize(forwarded);
+        }
+    }
+}
+
+BENCHMARK(SharedErrorForward)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(SharedErrorPerThread)->ThreadRange(1, 64)->UseRealTime();
+BENCHMARK(ConfinedErrorForward)->ThreadRange(1, 64)->UseRealTime();
@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <opex/hedge.h>
+
+namespace {
+    using namespace std::chrono;
+
+    // 1 in 20 requests stalls, like a backend that occasionally hits a slow replica.
+    struct SlowBackend {
+        std::shared_ptr<std::atomic<unsigned>> requests;
+
+        int operator()(const opex::cancel_token &token) const {
+            const auto stall = (requests->fetch_add(1) * 2654435761u >> 16) % 20 == 0;
+            const auto deadline = steady_clock::now() + (stall ? milliseconds(20) : microseconds(500));
+            while (steady_clock::now() < deadline && !token.is_cancelled())
+                std::this_thread::sleep_for(microseconds(100));
+            return 1;
+        }
+    };
+
+    void report(benchmark::State &state, std::vector<double> &latencies) {
+        std::sort(latencies.begin(), latencies.end());
+        state.counters["p50_us"] = latencies[latencies.size() / 2];
+        state.counters["p99_us"] = latencies[latencies.size() * 99 / 100];
+    }
+
+    template<typename Request>
+    void measure(benchmark::State &state, Request &&request) {
+        std::vector<double> latencies;
+        for (auto _ : state) {
+            const auto start = steady_clock::now();
+            benchmark::DoNotOptimize(request());
+            latencies.push_back(duration<double, std::micro>(steady_clock::now() - start).count());
+        }
+        report(state, latencies);
+    }
+
+    void Unhedged(benchmark::State &state) {
+        const SlowBackend backend{std::make_shared<std::atomic<unsigned>>(0)};
+        measure(state, [&] { return opex::call([&] { return backend(opex::cancel_token::never()); }); });
+    }
+
+    void Hedged(benchmark::State &state) {
+        const SlowBackend backend{std::make_shared<std::atomic<unsigned>>(0)};
+        measure(state, [&] { return opex::hedge(backend, backend, milliseconds(2)); });
+    }
+}
+
+BENCHMARK(Unhedged)->Iterations(400)->UseRealTime();
+BENCHMARK(Hedged)->Iterations(400)->UseRealTime();
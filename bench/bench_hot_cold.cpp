@@ -0,0 +1,99 @@
+#include <stdexcept>
+
+#include <benchmark/benchmark.h>
+#include <opex/opex.h>
+
+namespace {
+    using result_type = opex::result<int>;
+
+    constexpr int call_sites = 64;
+    constexpr int items = 4096;
+
+    const result_type &interned_error() {
+        static const auto error = result_type::make_exception<std::runtime_error>("interned");
+        return error;
+    }
+
+    // Error rate is given in percent.
+    result_type source(int i, int error_rate) {
+        return i % 100 < error_rate ? interned_error().map([](int v) { return v; }) : result_type{i};
+    }
+
+    template<int N>
+    int pipeline(int i, int error_rate) {
+        const auto r = source(i, error_rate)
+                .map([](int v) { return v + N; })
+                .and_then([](int v) { return result_type{v * 3}; })
+                .map([](int v) { return v ^ N; });
+        return r ? r.unwrap() : -1;
+    }
+
+    using pipeline_type = int (*)(int, int);
+
+    template<int N>
+    struct pipelines {
+        static void fill(pipeline_type *table) {
+            table[N - 1] = &pipeline<N - 1>;
+            pipelines<N - 1>::fill(table);
+        }
+    };
+
+    template<>
+    struct pipelines<0> {
+        static void fill(pipeline_type *) {}
+    };
+
+    struct error_code {
+        int value;
+        bool ok;
+    };
+
+    error_code error_code_pipeline(int i, int error_rate) {
+        if (i % 100 < error_rate)
+            return {0, false};
+        return {((i + 1) * 3) ^ 1, true};
+    }
+
+    void ErrorCodeBaseline(benchmark::State &state) {
+        const auto error_rate = static_cast<int>(state.range(0));
+        for (auto _ : state) {
+            int sum = 0;
+            for (int i = 0; i < items; ++i) {
+                const auto r = error_code_pipeline(i, error_rate);
+                sum += r.ok ? r.value : -1;
+            }
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * items);
+    }
+
+    void TightLoop(benchmark::State &state) {
+        const auto error_rate = static_cast<int>(state.range(0));
+        for (auto _ : state) {
+            int sum = 0;
+            for (int i = 0; i < items; ++i)
+                sum += pipeline<1>(i, error_rate);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * items);
+    }
+
+    // Cycles through many distinct instantiations so the combined hot paths compete for the instruction cache.
+    void ManyCallSites(benchmark::State &state) {
+        const auto error_rate = static_cast<int>(state.range(0));
+        pipeline_type table[call_sites];
+        pipelines<call_sites>::fill(table);
+
+        for (auto _ : state) {
+            int sum = 0;
+            for (int i = 0; i < items; ++i)
+                sum += table[i % call_sites](i, error_rate);
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * items);
+    }
+}
+
+BENCHMARK(ErrorCodeBaseline)->Arg(0)->Arg(1)->Arg(10);
+BENCHMARK(TightLoop)->Arg(0)->Arg(1)->Arg(10);
+BENCHMARK(ManyCallSites)->Arg(0)->Arg(1)->Arg(10);
@@ -0,0 +1,61 @@
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include <benchmark/benchmark.h>
+#include <opex/opex.h>
+
+namespace {
+    // Big enough that every extra relocation along a chain shows up as a memcpy.
+    using block = std::array<std::uint64_t, 64>;
+    using block_result = opex::result<block>;
+    using string_result = opex::result<std::string>;
+
+    block fill(std::uint64_t seed) {
+        block b;
+        for (auto &w : b)
+            w = seed++;
+        return b;
+    }
+
+    block bump(block &&b) {
+        for (auto &w : b)
+            w += 1;
+        return std::move(b);
+    }
+
+    void PlainBlockChain(benchmark::State &state) {
+        std::uint64_t seed = 0;
+        for (auto _ : state) {
+            auto b = bump(bump(bump(fill(seed++))));
+            benchmark::DoNotOptimize(b);
+        }
+    }
+
+    void ResultBlockChain(benchmark::State &state) {
+        std::uint64_t seed = 0;
+        for (auto _ : state) {
+            auto r = block_result::call([&seed] { return fill(seed++); })
+                    .map(bump)
+                    .map(bump)
+                    .and_then([](block &&b) { return block_result{bump(std::move(b))}; });
+            benchmark::DoNotOptimize(r);
+        }
+    }
+
+    void ResultStringChain(benchmark::State &state) {
+        const std::string payload(static_cast<std::size_t>(state.range(0)), 'x');
+        for (auto _ : state) {
+            auto r = string_result{payload}
+                    .map([](std::string &&s) { s += '!'; return std::move(s); })
+                    .and_then([](std::string &&s) { return string_result{std::move(s)}; })
+                    .context("step");
+            benchmark::DoNotOptimize(r);
+        }
+    }
+}
+
+BENCHMARK(PlainBlockChain);
+BENCHMARK(ResultBlockChain);
+BENCHMARK(ResultStringChain)->Arg(8)->Arg(256);
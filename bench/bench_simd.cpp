@@ -0,0 +1,132 @@
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <opex/simd.h>
+
+namespace {
+    constexpr std::size_t fields = 1 << 16;
+
+    // One error every error_every fields, as in mostly clean numeric ingestion.
+    template<typename T>
+    std::vector<opex::result<T>> parsed_fields(std::size_t error_every) {
+        std::vector<opex::result<T>> results;
+        results.reserve(fields);
+        for (std::size_t i = 0; i < fields; ++i) {
+            if (i % error_every == error_every - 1)
+                results.push_back(opex::result<T>::template make_exception<std::runtime_error>("bad field"));
+            else
+                results.push_back(opex::result<T>{static_cast<T>(i)});
+        }
+        return results;
+    }
+
+    bool select(benchmark::State &state) {
+        const auto isa = static_cast<opex::simd::isa>(state.range(0));
+        if (!opex::simd::use(isa)) {
+            state.SkipWithError("instruction set not supported");
+            return false;
+        }
+        return true;
+    }
+
+    void ScalarCountOk(benchmark::State &state) {
+        const auto results = parsed_fields<double>(100);
+        for (auto _ : state) {
+            std::size_t count = 0;
+            for (const auto &r : results)
+                count += r.is_ok() ? 1 : 0;
+            benchmark::DoNotOptimize(count);
+        }
+        state.SetItemsProcessed(state.iterations() * fields);
+    }
+
+    void SimdCountOk(benchmark::State &state) {
+        const auto results = parsed_fields<double>(100);
+        if (!select(state))
+            return;
+        for (auto _ : state)
+            benchmark::DoNotOptimize(opex::simd::count_ok(results.data(), results.size()));
+        state.SetItemsProcessed(state.iterations() * fields);
+    }
+
+    void ScalarFirstErrorIndex(benchmark::State &state) {
+        const auto results = parsed_fields<double>(fields);
+        for (auto _ : state) {
+            std::size_t index = 0;
+            while (index < results.size() && results[index].is_ok())
+                ++index;
+            benchmark::DoNotOptimize(index);
+        }
+        state.SetItemsProcessed(state.iterations() * fields);
+    }
+
+    void SimdFirstErrorIndex(benchmark::State &state) {
+        const auto results = parsed_fields<double>(fields);
+        if (!select(state))
+            return;
+        for (auto _ : state)
+            benchmark::DoNotOptimize(opex::simd::first_error_index(results.data(), results.size()));
+        state.SetItemsProcessed(state.iterations() * fields);
+    }
+
+    template<typename T>
+    void ScalarSumOk(benchmark::State &state) {
+        const auto results = parsed_fields<T>(100);
+        for (auto _ : state) {
+            T sum = 0;
+            for (const auto &r : results)
+                if (r.is_ok())
+                    sum += r.unwrap();
+            benchmark::DoNotOptimize(sum);
+        }
+        state.SetItemsProcessed(state.iterations() * fields);
+    }
+
+    template<typename T>
+    void SimdSumOk(benchmark::State &state) {
+        const auto results = parsed_fields<T>(100);
+        if (!select(state))
+            return;
+        for (auto _ : state)
+            benchmark::DoNotOptimize(opex::simd::sum_ok(results.data(), results.size()));
+        state.SetItemsProcessed(state.iterations() * fields);
+    }
+
+    void ScalarMap(benchmark::State &state) {
+        auto results = parsed_fields<double>(100);
+        for (auto _ : state) {
+            for (auto &r : results)
+                if (r.is_ok())
+                    r.unwrap() *= 1.0000001;
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * fields);
+    }
+
+    void SimdMap(benchmark::State &state) {
+        auto results = parsed_fields<double>(100);
+        for (auto _ : state) {
+            opex::simd::map(results.data(), results.size(), [](double v) { return v * 1.0000001; });
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(state.iterations() * fields);
+    }
+
+    void isas(benchmark::internal::Benchmark *b) {
+        for (auto isa : {opex::simd::isa::scalar, opex::simd::isa::sse2, opex::simd::isa::avx2, opex::simd::isa::avx512})
+            b->Arg(static_cast<int>(isa));
+    }
+}
+
+BENCHMARK(ScalarCountOk);
+BENCHMARK(SimdCountOk)->Apply(isas);
+BENCHMARK(ScalarFirstErrorIndex);
+BENCHMARK(SimdFirstErrorIndex)->Apply(isas);
+BENCHMARK_TEMPLATE(ScalarSumOk, double);
+BENCHMARK_TEMPLATE(SimdSumOk, double)->Apply(isas);
+BENCHMARK_TEMPLATE(ScalarSumOk, std::int64_t);
+BENCHMARK_TEMPLATE(SimdSumOk, std::int64_t)->Apply(isas);
+BENCHMARK(ScalarMap);
+BENCHMARK(SimdMap);
@@ -0,0 +1,88 @@
+# Measures how long the compiler frontend takes on generated translation units
+# that instantiate many distinct result types and combinator chains.
+#
+#   cmake -DCOMPILER=<c++> -DINCLUDE=<dir> [-DCOUNTS=100,400] [-DSTANDARDS=11,17]
+#         [-DWORK_DIR=<dir>] -P run.cmake
+#
+# Every unit is only parsed and instantiated (-fsyntax-only). Wall time is
+# measured around the compiler; with GCC the -ftime-report totals for memory
+# and template instantiation are reported as well.
+
+cmake_minimum_required(VERSION 3.23)
+
+if(NOT COMPILER OR NOT INCLUDE)
+    message(FATAL_ERROR "run.cmake needs COMPILER and INCLUDE")
+endif()
+if(NOT DEFINED COUNTS)
+    set(COUNTS "100,400")
+endif()
+if(NOT DEFINED STANDARDS)
+    set(STANDARDS "11,17")
+endif()
+if(NOT DEFINED WORK_DIR)
+    set(WORK_DIR "${CMAKE_CURRENT_BINARY_DIR}")
+endif()
+string(REPLACE "," ";" COUNTS "${COUNTS}")
+string(REPLACE "," ";" STANDARDS "${STANDARDS}")
+
+function(generate file count)
+    set(source "#include <stdexcept>\n#include <utility>\n\n#include <opex/opex.h>\n")
+    foreach(i RANGE 1 ${count})
+        string(APPEND source "
+struct value${i} { int x; };
+struct error${i} : std::runtime_error { explicit error${i}(const char *m): std::runtime_error(m) {} };
+using result${i} = opex::result<value${i}, error${i}>;
+
+result${i} chain${i}(const result${i} &in) {
+    auto mapped = in.map([](const value${i} &v) { return value${i}{v.x + 1}; })
+            .and_then([](value${i} &&v) { return result${i}{v}; })
+            .map_err([](error${i} &&) { return error${i}{\"again\"}; })
+            .or_else([](const error${i} &) { return result${i}{value${i}{0}}; });
+    return std::move(mapped).and_select_with([] { return result${i}::make_exception<error${i}>(\"late\"); });
+}
+")
+    endforeach()
+    file(WRITE "${file}" "${source}")
+endfunction()
+
+message("std    count  wall [s]   memory  instantiation [s]")
+foreach(standard IN LISTS STANDARDS)
+    foreach(count IN LISTS COUNTS)
+        set(file "${WORK_DIR}/compile_bench_${count}.cpp")
+        generate("${file}" ${count})
+
+        string(TIMESTAMP start "%s%f")
+        execute_process(
+            COMMAND "${COMPILER}" -std=c++${standard} -fsyntax-only -ftime-report -I "${INCLUDE}" "${file}"
+            RESULT_VARIABLE status
+            OUTPUT_VARIABLE report
+            ERROR_VARIABLE report
+        )
+        string(TIMESTAMP stop "%s%f")
+        if(NOT status EQUAL 0)
+            message(FATAL_ERROR "compiling ${file} as C++${standard} failed:\n${report}")
+        endif()
+
+        math(EXPR micros "${stop} - ${start}")
+        math(EXPR whole "${micros} / 1000000")
+        math(EXPR fraction "(${micros} % 1000000) / 10000")
+        if(fraction LESS 10)
+            set(fraction "0${fraction}")
+        endif()
+
+        set(memory "-")
+        set(instantiation "-")
+        if(report MATCHES "\n TOTAL[ \t]*:[ \t]*[0-9.]+[ \t]+[0-9.]+[ \t]+[0-9.]+[ \t]+([0-9]+[kMG]?)")
+            set(memory "${CMAKE_MATCH_1}")
+        endif()
+        if(report MATCHES "\n template instantiation[ \t]*:[ \t]*[0-9.]+[^0-9]+[0-9.]+[^0-9]+[0-9.]+[^0-9]+[0-9.]+[^0-9]+([0-9.]+)")
+            set(instantiation "${CMAKE_MATCH_1}")
+        endif()
+
+        string(LENGTH "${count}" width)
+        string(REPEAT " " 5 pad)
+        math(EXPR padding "5 - ${width}")
+        string(SUBSTRING "${pad}" 0 ${padding} pad)
+        message("c++${standard}  ${pad}${count}  ${whole}.${fraction}      ${memory}    ${instantiation}")
+    endforeach()
+endforeach()
@@ -0,0 +1,87 @@
+# Inspects the hot part of one function in an assembly listing.
+#
+#   cmake -DASM=<file.s> -DFUNCTION=<symbol> [-DMAX_INSTRUCTIONS=<n>] [-DMAX_BRANCHES=<n>]
+#         [-DALLOW_CALLS=ON] [-DFORBID=<regex>] -P check_asm.cmake
+#
+# Only code emitted in the function's own text section is counted; blocks the
+# compiler moved to .text.unlikely (the ".cold" parts) are ignored, as is the
+# exception table.
+
+if(NOT ASM OR NOT FUNCTION)
+    message(FATAL_ERROR "check_asm.cmake needs ASM and FUNCTION")
+endif()
+if(NOT DEFINED FORBID)
+    set(FORBID "__cxa_|rethrow_exception|_Unwind_|_Znw|_Zna|_Zdl|_Zda|malloc|calloc|realloc|free")
+endif()
+
+file(STRINGS "${ASM}" lines)
+
+set(in_function OFF)
+set(in_hot OFF)
+set(found OFF)
+set(instructions 0)
+set(branches 0)
+set(callees)
+set(body)
+
+foreach(line IN LISTS lines)
+    if(line MATCHES "^${FUNCTION}:")
+        set(in_function ON)
+        set(in_hot ON)
+        set(found ON)
+        continue()
+    endif()
+    if(NOT in_function)
+        continue()
+    endif()
+
+    if(line MATCHES "^[ \t]*\\.size[ \t]+${FUNCTION},")
+        break()
+    elseif(line MATCHES "^[ \t]*\\.section")
+        set(in_hot OFF)
+    elseif(line MATCHES "^[ \t]*\\.text[ \t]*$")
+        set(in_hot ON)
+    elseif(in_hot AND line MATCHES "^[ \t]+([a-z][a-z0-9.]*)([ \t]+(.*))?$")
+        set(mnemonic "${CMAKE_MATCH_1}")
+        set(operand "${CMAKE_MATCH_3}")
+        math(EXPR instructions "${instructions} + 1")
+        list(APPEND body "${line}")
+
+        if(mnemonic MATCHES "^call")
+            list(APPEND callees "${operand}")
+        elseif(mnemonic MATCHES "^jmp")
+            if(NOT operand MATCHES "^\\.L")
+                list(APPEND callees "${operand}")
+            endif()
+        elseif(mnemonic MATCHES "^j")
+            math(EXPR branches "${branches} + 1")
+        endif()
+    endif()
+endforeach()
+
+if(NOT found)
+    message(FATAL_ERROR "${FUNCTION} not found in ${ASM}")
+endif()
+
+set(failures)
+if(DEFINED MAX_INSTRUCTIONS AND instructions GREATER MAX_INSTRUCTIONS)
+    list(APPEND failures "${instructions} instructions exceed the budget of ${MAX_INSTRUCTIONS}")
+endif()
+if(DEFINED MAX_BRANCHES AND branches GREATER MAX_BRANCHES)
+    list(APPEND failures "${branches} conditional branches exceed the budget of ${MAX_BRANCHES}")
+endif()
+foreach(callee IN LISTS callees)
+    if(NOT ALLOW_CALLS)
+        list(APPEND failures "unexpected call to ${callee}")
+    elseif(callee MATCHES "${FORBID}")
+        list(APPEND failures "forbidden call to ${callee}")
+    endif()
+endforeach()
+
+if(failures)
+    string(REPLACE ";" "\n" body "${body}")
+    string(REPLACE ";" "\n  " failures "${failures}")
+    message(FATAL_ERROR "${FUNCTION}:\n  ${failures}\nhot path:\n${body}")
+endif()
+
+message(STATUS "${FUNCTION}: ${instructions} instructions, ${branches} conditional branches")
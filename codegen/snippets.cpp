@@ -0,0 +1,68 @@
+#include <opex/opex.h>
+#include <opex/zip.h>
+
+namespace {
+    using result_type = opex::result<int>;
+
+    result_type ok(int x) {
+        return result_type{x};
+    }
+}
+
+extern "C" {
+    int opex_codegen_call_unwrap(int x) {
+        return opex::call([x] { return x * 2; }).unwrap();
+    }
+
+    int opex_codegen_map_unwrap(int x) {
+        return ok(x).map([](int v) { return v + 1; }).unwrap();
+    }
+
+    int opex_codegen_and_then_unwrap(int x) {
+        return ok(x).and_then([](int v) { return ok(v * 3); }).unwrap();
+    }
+
+    int opex_codegen_chain_unwrap(int x) {
+        return opex::call([x] { return x + 1; })
+                .map([](int v) { return v * 2; })
+                .and_then([](int v) { return ok(v - 1); })
+                .unwrap();
+    }
+
+    int opex_codegen_apply_unwrap(int x, int y) {
+        return opex::apply([](int a, int b) { return a + b; }, ok(x), ok(y)).unwrap();
+    }
+
+    int opex_codegen_zip_unwrap(int x, int y) {
+        const auto values = opex::zip(ok(x), ok(y)).unwrap();
+        return std::get<0>(values) * std::get<1>(values);
+    }
+
+    result_type opex_codegen_map(const result_type &r) {
+        return r.map([](int v) { return v + 1; });
+    }
+
+    result_type opex_codegen_map_rvalue(result_type &&r) {
+        return std::move(r).map([](int v) { return v + 1; });
+    }
+
+    result_type opex_codegen_and_then(const result_type &r) {
+        return r.and_then([](int v) { return ok(v * 3); });
+    }
+
+    result_type opex_codegen_or_else(const result_type &r) {
+        return r.or_else([](const std::exception &) { return ok(0); });
+    }
+
+    bool opex_codegen_operator_bool(const result_type &r) {
+        return static_cast<bool>(r);
+    }
+
+    int opex_codegen_unwrap(const result_type &r) {
+        return r.unwrap();
+    }
+
+    int opex_codegen_value_or(const result_type &r, int fallback) {
+        return r ? *r : fallback;
+    }
+}
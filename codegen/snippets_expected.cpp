@@ -0,0 +1,60 @@
+#include <system_error>
+
+#include <opex/expected.h>
+
+namespace {
+    using result_type = opex::result<int>;
+    using expected_type = opex::expected<int>;
+
+    using value_type_result = opex::value_result<int, std::errc>;
+
+    result_type ok(int x) {
+        return result_type{x};
+    }
+
+    value_type_result value_ok(int x) {
+        return value_type_result{x};
+    }
+}
+
+// Crossing between result and std::expected should cost nothing on the value path: each of these is held to
+// the budget of the plain result chain it wraps.
+extern "C" {
+    int opex_codegen_cxx23_chain_unwrap(int x) {
+        return opex::call([x] { return x + 1; })
+                .map([](int v) { return v * 2; })
+                .and_then([](int v) { return ok(v - 1); })
+                .unwrap();
+    }
+
+    int opex_codegen_to_expected_value(int x) {
+        return opex::to_expected(ok(x).map([](int v) { return v + 1; })).value();
+    }
+
+    int opex_codegen_from_expected_unwrap(int x) {
+        return opex::from_expected(expected_type{x + 1}).unwrap();
+    }
+
+    int opex_codegen_expected_round_trip(int x) {
+        return opex::from_expected(opex::to_expected(opex::call([x] { return x + 1; })))
+                .map([](int v) { return v * 2; })
+                .unwrap();
+    }
+
+    // The std::expected backend against the same chain written directly on std::expected.
+    int opex_codegen_value_backend_chain_unwrap(int x) {
+        return value_type_result::call([x] { return x + 1; })
+                .map([](int v) { return v * 2; })
+                .and_then([](int v) { return value_ok(v - 1); })
+                .unwrap();
+    }
+
+    int opex_codegen_std_expected_chain_value(int x) {
+        std::expected<int, std::errc> e{x + 1};
+        if (e)
+            e = *e * 2;
+        if (e)
+            e = *e - 1;
+        return e.value();
+    }
+}
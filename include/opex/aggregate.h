@@ -0,0 +1,269 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+#include <opex/opex.h>
+
+namespace opex {
+    namespace _agg {
+        inline std::string type_name(const std::type_info &type) {
+#if defined(__GNUG__)
+            int status = 0;
+            std::unique_ptr<char, void (*)(void *)> name{abi::__cxa_demangle(type.name(), nullptr, nullptr, &status),
+                                                         std::free};
+            if (status == 0 && name)
+                return name.get();
+#endif
+            return type.name();
+        }
+    }
+
+    class aggregate_error : public std::exception {
+        struct record {
+            std::size_t index;
+            const std::type_info *type;
+            std::size_t offset;
+        };
+
+        // Records of errors added from results are resolved, one rethrow each, the first time anything but the
+        // count is asked for. Adding an error drops the resolved copy.
+        struct resolved {
+            std::vector<record> records;
+            std::vector<char> text;
+        };
+
+        class cached_resolved {
+        public:
+            cached_resolved() noexcept: m_value(nullptr) {}
+            cached_resolved(const cached_resolved &) noexcept: m_value(nullptr) {}
+            cached_resolved& operator=(const cached_resolved &) noexcept { reset(); return *this; }
+            ~cached_resolved() { reset(); }
+
+            void reset() noexcept { delete m_value.exchange(nullptr); }
+
+            template<typename Resolve>
+            const resolved& get(Resolve &&resolve) const {
+                if (const auto value = m_value.load(std::memory_order_acquire))
+                    return *value;
+
+                const auto fresh = new resolved(resolve());
+                const resolved *expected = nullptr;
+                if (!m_value.compare_exchange_strong(expected, fresh, std::memory_order_acq_rel)) {
+                    delete fresh;
+                    return *expected;
+                }
+                return *fresh;
+            }
+
+        private:
+            mutable std::atomic<const resolved*> m_value;
+        };
+
+    public:
+        class error_view {
+        public:
+            std::size_t index() const noexcept { return m_record->index; }
+            const std::type_info& type() const noexcept { return *m_record->type; }
+            const char* what() const noexcept { return m_text + m_record->offset; }
+
+        private:
+            error_view(const record *r, const char *text): m_record(r), m_text(text) {}
+
+            const record *m_record;
+            const char *m_text;
+
+            friend class aggregate_error;
+            friend class const_iterator;
+        };
+
+        class const_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = error_view;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = error_view;
+
+            const_iterator(): m_record(nullptr), m_text(nullptr) {}
+
+            error_view operator*() const noexcept { return {m_record, m_text}; }
+
+            const_iterator& operator++() noexcept { ++m_record; return *this; }
+            const_iterator  operator++(int) noexcept { auto tmp = *this; ++m_record; return tmp; }
+
+            bool operator==(const const_iterator &other) const noexcept { return m_record == other.m_record; }
+            bool operator!=(const const_iterator &other) const noexcept { return m_record != other.m_record; }
+
+        private:
+            const_iterator(const record *r, const char *text): m_record(r), m_text(text) {}
+
+            const record *m_record;
+            const char *m_text;
+
+            friend class aggregate_error;
+        };
+
+        aggregate_error() = default;
+
+        explicit aggregate_error(std::size_t expected_errors) {
+            reserve(expected_errors);
+        }
+
+        void reserve(std::size_t expected_errors) {
+            m_records.reserve(expected_errors);
+        }
+
+        void add(std::size_t index, const std::exception &exception) {
+            add(index, typeid(exception), exception.what());
+        }
+
+        void add(std::size_t index, const std::type_info &type, const char *message) {
+            const auto length = std::strlen(message);
+            m_records.push_back(record{index, &type, m_text.size()});
+            m_text.insert(m_text.end(), message, message + length + 1);
+            changed();
+        }
+
+        // Keeps the result's exception as is; its type and message are read when the errors are inspected.
+        template<typename ValueType, typename ExceptionType, typename ErrorHandle>
+        void add(std::size_t index, const result<ValueType, ExceptionType, ErrorHandle> &r) {
+            static_assert(std::is_base_of<std::exception, ExceptionType>::value,
+                          "aggregate_error can only hold std::exception derived errors");
+            if (r.is_err()) {
+                m_records.push_back(record{index, nullptr, m_pending.size()});
+                m_pending.push_back(_t::access::exception(r));
+                changed();
+            }
+        }
+
+        std::size_t size() const noexcept { return m_records.size(); }
+        bool empty() const noexcept { return m_records.empty(); }
+
+        const_iterator begin() const { return {records(), text()}; }
+        const_iterator end() const { return {records() + m_records.size(), text()}; }
+
+        error_view operator[](std::size_t i) const { return {&records()[i], text()}; }
+
+        std::size_t count(const std::type_info &type) const {
+            std::size_t n = 0;
+            for (auto r = records(), last = r + m_records.size(); r != last; ++r)
+                if (*r->type == type)
+                    ++n;
+            return n;
+        }
+
+        template<typename ExceptionType>
+        std::size_t count() const { return count(typeid(ExceptionType)); }
+
+        const char* what() const noexcept override {
+            return m_summary.get([this] { return summarize(); }, "opex::aggregate_error");
+        }
+
+    private:
+        void changed() noexcept {
+            m_resolved.reset();
+            m_summary.reset();
+        }
+
+        const record* records() const { return m_pending.empty() ? m_records.data() : resolve().records.data(); }
+        const char* text() const { return m_pending.empty() ? m_text.data() : resolve().text.data(); }
+
+        const resolved& resolve() const {
+            return m_resolved.get([this] {
+                resolved r{m_records, m_text};
+                for (auto &rec : r.records) {
+                    if (rec.type)
+                        continue;
+                    const char *message = "unknown error";
+                    try {
+                        std::rethrow_exception(m_pending[rec.offset]);
+                    } catch (const std::exception &e) {
+                        rec.type = &typeid(e);
+                        message = e.what();
+                    } catch (...) {
+                        rec.type = &typeid(void);
+                    }
+                    rec.offset = r.text.size();
+                    r.text.insert(r.text.end(), message, message + std::strlen(message) + 1);
+                }
+                return r;
+            });
+        }
+
+        std::string summarize() const {
+            if (m_records.empty())
+                return "no errors";
+
+            std::vector<std::pair<const std::type_info*, std::size_t>> per_type;
+            const auto first = records();
+            for (auto r = first, last = first + m_records.size(); r != last; ++r) {
+                auto it = per_type.begin();
+                while (it != per_type.end() && *it->first != *r->type)
+                    ++it;
+                if (it == per_type.end())
+                    per_type.emplace_back(r->type, 1);
+                else
+                    ++it->second;
+            }
+
+            auto summary = std::to_string(m_records.size()) + (m_records.size() == 1 ? " error (" : " errors (");
+            for (auto it = per_type.begin(); it != per_type.end(); ++it) {
+                if (it != per_type.begin())
+                    summary += ", ";
+                summary += std::to_string(it->second) + " x " + _agg::type_name(*it->first);
+            }
+            summary += "); first at [" + std::to_string(first->index) + "]: ";
+            summary += text() + first->offset;
+            return summary;
+        }
+
+        std::vector<record> m_records;
+        std::vector<char> m_text;
+        std::vector<std::exception_ptr> m_pending;
+        cached_resolved m_resolved;
+        _t::cached_string m_summary;
+    };
+
+
+    template<typename ExceptionType = std::exception, typename InputIt, typename Func,
+             typename ValueType = _t::call_result_t<Func, typename std::iterator_traits<InputIt>::reference>>
+    result<std::vector<ValueType>, aggregate_error> call_each(InputIt first, InputIt last, Func &&func) {
+        static_assert(std::is_base_of<std::exception, ExceptionType>::value,
+                      "call_each can only aggregate std::exception derived errors");
+
+        std::vector<ValueType> values;
+        aggregate_error errors;
+
+        std::size_t index = 0;
+        for (; first != last; ++first, ++index) {
+            auto r = result<ValueType, ExceptionType>::call([&]() -> ValueType { return func(*first); });
+            if (OPEX_LIKELY(r.is_ok()))
+                values.push_back(std::move(r).unwrap());
+            else
+                errors.add(index, r);
+        }
+
+        if (!errors.empty())
+            return result<std::vector<ValueType>, aggregate_error>::from_exception(std::move(errors));
+        return result<std::vector<ValueType>, aggregate_error>{std::move(values)};
+    }
+
+    template<typename ExceptionType = std::exception, typename Container, typename Func>
+    auto call_each(const Container &container, Func &&func)
+            -> decltype(call_each<ExceptionType>(std::begin(container), std::end(container), std::forward<Func>(func))) {
+        return call_each<ExceptionType>(std::begin(container), std::end(container), std::forward<Func>(func));
+    }
+}
@@ -0,0 +1,735 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <opex/opex.h>
+
+namespace opex {
+    class broken_promise : public std::logic_error {
+    public:
+        broken_promise(): std::logic_error("opex::promise destroyed without a result") {}
+    };
+
+    template<typename ValueType, typename ExceptionType = std::exception>
+    class async_result;
+
+    template<typename ValueType, typename ExceptionType = std::exception>
+    class promise;
+
+    namespace _a {
+        struct task {
+            explicit task(void (*run)(task *)) noexcept: next(nullptr), run(run) {}
+
+            task *next;
+            void (*run)(task *);
+        };
+
+        template<typename Func>
+        class closure final : public task {
+        public:
+            explicit closure(Func &&func): task(&closure::invoke), m_func(std::move(func)) {}
+
+        private:
+            static void invoke(task *t) {
+                std::unique_ptr<closure> self(static_cast<closure*>(t));
+                self->m_func();
+            }
+
+            Func m_func;
+        };
+    }
+
+    class executor {
+    public:
+        virtual ~executor() = default;
+
+        // The task must stay alive until its run function returns; run may destroy it.
+        virtual void post(_a::task &t) = 0;
+
+        template<typename Func>
+        void submit(Func &&func) {
+            std::unique_ptr<_a::closure<typename std::decay<Func>::type>> t(
+                    new _a::closure<typename std::decay<Func>::type>(std::forward<Func>(func)));
+            post(*t);
+            t.release();
+        }
+    };
+
+    class inline_executor : public executor {
+    public:
+        void post(_a::task &t) override { t.run(&t); }
+    };
+
+    // Fixed set of workers draining one FIFO of intrusive tasks. Destruction runs what is queued, then joins.
+    class thread_pool : public executor {
+    public:
+        explicit thread_pool(std::size_t threads = std::thread::hardware_concurrency()):
+                m_head(nullptr),
+                m_tail(nullptr),
+                m_stopping(false)
+        {
+            threads = std::max<std::size_t>(threads, 1);
+            m_threads.reserve(threads);
+            for (std::size_t i = 0; i < threads; ++i)
+                m_threads.emplace_back([this] { work(); });
+        }
+
+        thread_pool(const thread_pool &) = delete;
+        thread_pool& operator=(const thread_pool &) = delete;
+
+        ~thread_pool() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+            }
+            m_ready.notify_all();
+            for (auto &t : m_threads)
+                t.join();
+        }
+
+        std::size_t size() const noexcept { return m_threads.size(); }
+
+        void post(_a::task &t) override {
+            t.next = nullptr;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_tail)
+                    m_tail->next = &t;
+                else
+                    m_head = &t;
+                m_tail = &t;
+            }
+            m_ready.notify_one();
+        }
+
+    private:
+        void work() {
+            for (;;) {
+                _a::task *t;
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_ready.wait(lock, [this] { return m_head != nullptr || m_stopping; });
+                    if (!m_head)
+                        return;
+                    t = m_head;
+                    m_head = t->next;
+                    if (!m_head)
+                        m_tail = nullptr;
+                }
+                t->run(t);
+            }
+        }
+
+        std::mutex m_mutex;
+        std::condition_variable m_ready;
+        _a::task *m_head;
+        _a::task *m_tail;
+        bool m_stopping;
+        std::vector<std::thread> m_threads;
+    };
+
+    namespace _a {
+        constexpr std::size_t arena_capacity = 1024;
+
+        // Every stage of a chain is carved out of one block; a long chain spills into a fresh block. Only the
+        // holder of the chain's tail allocates, so the bump pointer needs no synchronisation.
+        class arena {
+        public:
+            static arena* create(std::size_t capacity) {
+                return new(::operator new(sizeof(arena) + capacity)) arena(capacity);
+            }
+
+            void* allocate(std::size_t size, std::size_t align) noexcept {
+                const auto base = reinterpret_cast<std::uintptr_t>(this + 1);
+                const auto at = ((base + m_used + align - 1) & ~(std::uintptr_t(align) - 1)) - base;
+                if (at + size > m_capacity)
+                    return nullptr;
+                m_used = at + size;
+                m_refs.fetch_add(1, std::memory_order_relaxed);
+                return reinterpret_cast<unsigned char*>(this + 1) + at;
+            }
+
+            void release() noexcept {
+                if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    this->~arena();
+                    ::operator delete(this);
+                }
+            }
+
+        private:
+            explicit arena(std::size_t capacity): m_refs(0), m_used(0), m_capacity(capacity) {}
+
+            std::atomic<unsigned> m_refs;
+            std::size_t m_used;
+            const std::size_t m_capacity;
+        };
+
+        template<typename NodeType, typename... Args>
+        NodeType* make(arena *current, Args &&... args) {
+            void *memory = current ? current->allocate(sizeof(NodeType), alignof(NodeType)) : nullptr;
+            if (!memory) {
+                const std::size_t needed = sizeof(NodeType) + alignof(NodeType);
+                current = arena::create(needed < arena_capacity ? arena_capacity : needed);
+                memory = current->allocate(sizeof(NodeType), alignof(NodeType));
+            }
+
+            struct guard {
+                ~guard() { if (a) a->release(); }
+                arena *a;
+            } g{current};
+            const auto node = new(memory) NodeType(current, std::forward<Args>(args)...);
+            g.a = nullptr;
+            return node;
+        }
+
+        template<typename ResultType>
+        class receiver {
+        public:
+            virtual void receive(ResultType &&r) noexcept = 0;
+
+        protected:
+            ~receiver() = default;
+        };
+
+        // A node starts with two references: one for whoever completes it and one for whoever consumes it.
+        template<typename ResultType>
+        class node {
+        public:
+            node(const node &) = delete;
+            node& operator=(const node &) = delete;
+
+            void complete(ResultType &&r) noexcept {
+                new(&m_result) ResultType(std::move(r));
+                int expected = empty;
+                if (!m_state.compare_exchange_strong(expected, has_result, std::memory_order_acq_rel))
+                    deliver();
+            }
+
+            // Hands the consumer reference to the receiver side; it is dropped once the result was delivered.
+            void attach(receiver<ResultType> &r) noexcept {
+                m_receiver = &r;
+                int expected = empty;
+                if (!m_state.compare_exchange_strong(expected, has_receiver, std::memory_order_acq_rel))
+                    deliver();
+            }
+
+            bool is_ready() const noexcept { return m_state.load(std::memory_order_acquire) == has_result; }
+
+            arena* get_arena() const noexcept { return m_arena; }
+
+            void release() noexcept {
+                if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    const auto a = m_arena;
+                    this->~node();
+                    a->release();
+                }
+            }
+
+        protected:
+            explicit node(arena *a) noexcept:
+                    m_state(empty),
+                    m_refs(2),
+                    m_receiver(nullptr),
+                    m_arena(a)
+            {}
+
+            virtual ~node() {
+                if (m_state.load(std::memory_order_relaxed) == has_result)
+                    result().~ResultType();
+            }
+
+        private:
+            enum : int { empty, has_receiver, has_result, delivered };
+
+            ResultType& result() noexcept { return *reinterpret_cast<ResultType*>(&m_result); }
+
+            void deliver() noexcept {
+                m_state.store(delivered, std::memory_order_relaxed);
+                m_receiver->receive(std::move(result()));
+                result().~ResultType();
+                release();
+            }
+
+            std::atomic<int> m_state;
+            std::atomic<unsigned> m_refs;
+            receiver<ResultType> *m_receiver;
+            arena *const m_arena;
+            typename std::aligned_storage<sizeof(ResultType), alignof(ResultType)>::type m_result;
+        };
+
+        template<typename ResultType>
+        class promise_node final : public node<ResultType> {
+        public:
+            explicit promise_node(arena *a) noexcept: node<ResultType>(a) {}
+        };
+
+        // Exceptions of the output's exception type become errors, as with result::call. Anything else has
+        // nowhere to go once the chain runs detached and terminates.
+        template<typename OutResult, typename Step, typename... Args>
+        OutResult capture(Step &step, Args &&... args) noexcept {
+#ifdef OPEX_NO_EXCEPTIONS
+            return step(std::forward<Args>(args)...);
+#else
+            try {
+                return step(std::forward<Args>(args)...);
+            } catch (const typename OutResult::exception_type &) {
+                return _t::access::from_exception_ptr<OutResult>(std::current_exception());
+            }
+#endif
+        }
+
+        template<typename ResultType>
+        class input {
+        public:
+            void store(ResultType &&r) noexcept { new(&m_storage) ResultType(std::move(r)); }
+
+            ResultType take() noexcept {
+                auto &stored = *reinterpret_cast<ResultType*>(&m_storage);
+                ResultType r{std::move(stored)};
+                stored.~ResultType();
+                return r;
+            }
+
+        private:
+            typename std::aligned_storage<sizeof(ResultType), alignof(ResultType)>::type m_storage;
+        };
+
+        template<typename InResult, typename OutResult, typename Step>
+        class link final : public node<OutResult>, public receiver<InResult>, public task {
+        public:
+            link(arena *a, Step &&step, executor *ex):
+                    node<OutResult>(a),
+                    task(&link::run_posted),
+                    m_step(std::move(step)),
+                    m_executor(ex)
+            {}
+
+            void receive(InResult &&r) noexcept override {
+                if (!m_executor)
+                    return finish(std::move(r));
+                m_input.store(std::move(r));
+                m_executor->post(*this);
+            }
+
+        private:
+            static void run_posted(task *t) {
+                auto &self = static_cast<link&>(*t);
+                self.finish(self.m_input.take());
+            }
+
+            void finish(InResult &&r) noexcept {
+                this->complete(capture<OutResult>(m_step, std::move(r)));
+                this->release();
+            }
+
+            Step m_step;
+            executor *const m_executor;
+            input<InResult> m_input;
+        };
+
+        template<typename InResult, typename OutResult, typename Func>
+        class flat_link final : public node<OutResult>, public receiver<InResult>, public task {
+        public:
+            flat_link(arena *a, Func &&func, executor *ex):
+                    node<OutResult>(a),
+                    task(&flat_link::run_posted),
+                    m_func(std::move(func)),
+                    m_executor(ex),
+                    m_relay(*this)
+            {}
+
+            void receive(InResult &&r) noexcept override {
+                if (!m_executor)
+                    return start(std::move(r));
+                m_input.store(std::move(r));
+                m_executor->post(*this);
+            }
+
+        private:
+            struct relay final : receiver<OutResult> {
+                explicit relay(flat_link &owner): self(owner) {}
+
+                void receive(OutResult &&r) noexcept override {
+                    self.complete(std::move(r));
+                    self.release();
+                }
+
+                flat_link &self;
+            };
+
+            static void run_posted(task *t) {
+                auto &self = static_cast<flat_link&>(*t);
+                self.start(self.m_input.take());
+            }
+
+            void start(InResult &&r) noexcept;
+
+            Func m_func;
+            executor *const m_executor;
+            input<InResult> m_input;
+            relay m_relay;
+        };
+
+        template<typename ResultType, typename Func>
+        class source final : public node<ResultType>, public task {
+        public:
+            source(arena *a, Func &&func):
+                    node<ResultType>(a),
+                    task(&source::run_posted),
+                    m_func(std::move(func))
+            {}
+
+        private:
+            static void run_posted(task *t) {
+                auto &self = static_cast<source&>(*t);
+                self.complete(call(self.m_func));
+                self.release();
+            }
+
+            static ResultType call(Func &func) noexcept { return ResultType::call(func); }
+
+            Func m_func;
+        };
+
+        template<typename ResultType>
+        class waiter final : public receiver<ResultType> {
+        public:
+            waiter(): m_done(false), m_released(false) {}
+
+            // Notifies outside the lock so the waiting thread does not wake into a held mutex; m_released is
+            // the last thing touched here, after which wait() may return and destroy the waiter.
+            void receive(ResultType &&r) noexcept override {
+                m_input.store(std::move(r));
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_done = true;
+                }
+                m_ready.notify_one();
+                m_released.store(true, std::memory_order_release);
+            }
+
+            ResultType wait() {
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_ready.wait(lock, [this] { return m_done; });
+                }
+                while (!m_released.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+                return m_input.take();
+            }
+
+        private:
+            std::mutex m_mutex;
+            std::condition_variable m_ready;
+            bool m_done;
+            std::atomic<bool> m_released;
+            input<ResultType> m_input;
+        };
+
+        template<typename ResultType>
+        using async_of_t = async_result<typename ResultType::value_type, typename ResultType::exception_type>;
+
+        template<typename ResultType, typename Step>
+        using step_result_t = decltype(std::declval<Step&>()(std::declval<ResultType&&>()));
+
+        template<typename>
+        struct is_async : std::false_type {};
+
+        template<typename V, typename E>
+        struct is_async<async_result<V, E>> : std::true_type {};
+
+        template<typename Func>
+        struct map_step {
+            template<typename R>
+            auto operator()(R &&r) -> decltype(std::move(r).map(std::declval<Func&>())) { return std::move(r).map(func); }
+
+            Func func;
+        };
+
+        template<typename Func>
+        struct and_then_step {
+            template<typename R>
+            auto operator()(R &&r) -> decltype(std::move(r).and_then(std::declval<Func&>())) { return std::move(r).and_then(func); }
+
+            Func func;
+        };
+
+        template<typename Func>
+        struct or_else_step {
+            template<typename R>
+            auto operator()(R &&r) -> decltype(std::move(r).or_else(std::declval<Func&>())) { return std::move(r).or_else(func); }
+
+            Func func;
+        };
+
+        template<typename Func>
+        struct map_err_step {
+            template<typename R>
+            auto operator()(R &&r) -> decltype(std::move(r).map_err(std::declval<Func&>())) { return std::move(r).map_err(func); }
+
+            Func func;
+        };
+
+        template<typename ResultType, _t::enable_if_t<ResultType::template is_allowed_exception<broken_promise>::value>* = nullptr>
+        ResultType broken() {
+            return ResultType::template make_exception<broken_promise>();
+        }
+
+        template<typename ResultType, _t::enable_if_t<!ResultType::template is_allowed_exception<broken_promise>::value>* = nullptr>
+        ResultType broken() {
+            _e::fail("opex::promise destroyed without a result");
+        }
+
+        struct access {
+            template<typename AsyncType, typename NodeType>
+            static AsyncType wrap(NodeType *n) noexcept { return AsyncType{n}; }
+
+            template<typename AsyncType>
+            static auto take(AsyncType &&a) -> decltype(a.take()) { return a.take(); }
+        };
+    }
+
+    // Future side of a promise or of an async chain. Continuations consume the instance and run on the thread
+    // that completes the previous stage, or on the given executor.
+    template<typename ValueType, typename ExceptionType>
+    class async_result {
+    public:
+        using result_type = result<ValueType, ExceptionType>;
+        using value_type = ValueType;
+        using exception_type = ExceptionType;
+
+        async_result(async_result &&other) noexcept: m_node(other.m_node) { other.m_node = nullptr; }
+        async_result(const async_result &) = delete;
+
+        async_result& operator=(async_result &&other) noexcept {
+            if (this != &other) {
+                if (m_node)
+                    m_node->release();
+                m_node = other.m_node;
+                other.m_node = nullptr;
+            }
+            return *this;
+        }
+
+        ~async_result() {
+            if (m_node)
+                m_node->release();
+        }
+
+        bool valid() const noexcept { return m_node != nullptr; }
+        bool is_ready() const noexcept { return m_node && m_node->is_ready(); }
+
+        result_type get() && {
+            _a::waiter<result_type> w;
+            take()->attach(w);
+            return w.wait();
+        }
+
+        template<typename Func, typename Step = _a::map_step<typename std::decay<Func>::type>>
+        _a::async_of_t<_a::step_result_t<result_type, Step>> map(Func &&func) && {
+            return then(Step{std::forward<Func>(func)}, nullptr);
+        }
+
+        template<typename Func, typename Step = _a::map_step<typename std::decay<Func>::type>>
+        _a::async_of_t<_a::step_result_t<result_type, Step>> map(Func &&func, executor &ex) && {
+            return then(Step{std::forward<Func>(func)}, &ex);
+        }
+
+        template<typename Func, typename Step = _a::and_then_step<typename std::decay<Func>::type>,
+                 _t::enable_if_t<!_a::is_async<_t::call_result_t<Func&, ValueType&&>>::value>* = nullptr>
+        _a::async_of_t<_a::step_result_t<result_type, Step>> and_then(Func &&func) && {
+            return then(Step{std::forward<Func>(func)}, nullptr);
+        }
+
+        template<typename Func, typename Step = _a::and_then_step<typename std::decay<Func>::type>,
+                 _t::enable_if_t<!_a::is_async<_t::call_result_t<Func&, ValueType&&>>::value>* = nullptr>
+        _a::async_of_t<_a::step_result_t<result_type, Step>> and_then(Func &&func, executor &ex) && {
+            return then(Step{std::forward<Func>(func)}, &ex);
+        }
+
+        template<typename Func, typename AsyncType = _t::call_result_t<Func&, ValueType&&>,
+                 _t::enable_if_t<_a::is_async<AsyncType>::value>* = nullptr>
+        AsyncType and_then(Func &&func) && {
+            return flatten<AsyncType>(std::forward<Func>(func), nullptr);
+        }
+
+        template<typename Func, typename AsyncType = _t::call_result_t<Func&, ValueType&&>,
+                 _t::enable_if_t<_a::is_async<AsyncType>::value>* = nullptr>
+        AsyncType and_then(Func &&func, executor &ex) && {
+            return flatten<AsyncType>(std::forward<Func>(func), &ex);
+        }
+
+        template<typename Func, typename Step = _a::or_else_step<typename std::decay<Func>::type>>
+        _a::async_of_t<_a::step_result_t<result_type, Step>> or_else(Func &&func) && {
+            return then(Step{std::forward<Func>(func)}, nullptr);
+        }
+
+        template<typename Func, typename Step = _a::or_else_step<typename std::decay<Func>::type>>
+        _a::async_of_t<_a::step_result_t<result_type, Step>> or_else(Func &&func, executor &ex) && {
+            return then(Step{std::forward<Func>(func)}, &ex);
+        }
+
+        template<typename Func, typename Step = _a::map_err_step<typename std::decay<Func>::type>>
+        _a::async_of_t<_a::step_result_t<result_type, Step>> map_err(Func &&func) && {
+            return then(Step{std::forward<Func>(func)}, nullptr);
+        }
+
+        template<typename Func, typename Step = _a::map_err_step<typename std::decay<Func>::type>>
+        _a::async_of_t<_a::step_result_t<result_type, Step>> map_err(Func &&func, executor &ex) && {
+            return then(Step{std::forward<Func>(func)}, &ex);
+        }
+
+    private:
+        explicit async_result(_a::node<result_type> *n) noexcept: m_node(n) {}
+
+        _a::node<result_type>& state() const {
+            if (!m_node)
+                _e::raise<std::logic_error>("opex::async_result has no state");
+            return *m_node;
+        }
+
+        _a::node<result_type>* take() {
+            const auto n = &state();
+            m_node = nullptr;
+            return n;
+        }
+
+        template<typename Step, typename OutResult = _a::step_result_t<result_type, Step>>
+        _a::async_of_t<OutResult> then(Step &&step, executor *ex) {
+            static_assert(std::is_same<typename OutResult::error_handle, shared_error_handle>::value,
+                          "async continuations must produce results with a shared_error_handle");
+
+            const auto next = _a::make<_a::link<result_type, OutResult, Step>>(state().get_arena(), std::move(step), ex);
+            take()->attach(*next);
+            return _a::access::wrap<_a::async_of_t<OutResult>>(next);
+        }
+
+        template<typename AsyncType, typename Func>
+        AsyncType flatten(Func &&func, executor *ex) {
+            using out_result = typename AsyncType::result_type;
+            using link_type = _a::flat_link<result_type, out_result, typename std::decay<Func>::type>;
+            static_assert(std::is_base_of<typename AsyncType::exception_type, ExceptionType>::value,
+                          "and_then continuations must widen to a base of the current exception type");
+
+            const auto next = _a::make<link_type>(state().get_arena(), typename std::decay<Func>::type(std::forward<Func>(func)), ex);
+            take()->attach(*next);
+            return _a::access::wrap<AsyncType>(next);
+        }
+
+        _a::node<result_type> *m_node;
+
+        friend struct _a::access;
+    };
+
+    template<typename InResult, typename OutResult, typename Func>
+    void _a::flat_link<InResult, OutResult, Func>::start(InResult &&r) noexcept {
+        if (r.is_err()) {
+            this->complete(_t::access::error_as<OutResult>(std::move(r)));
+            this->release();
+            return;
+        }
+
+        struct step {
+            Func &func;
+            async_of_t<OutResult> operator()(InResult &&r) { return func(std::move(r).unwrap()); }
+        } call{m_func};
+#ifdef OPEX_NO_EXCEPTIONS
+        access::take(call(std::move(r)))->attach(m_relay);
+#else
+        try {
+            access::take(call(std::move(r)))->attach(m_relay);
+        } catch (const typename OutResult::exception_type &) {
+            this->complete(_t::access::from_exception_ptr<OutResult>(std::current_exception()));
+            this->release();
+        }
+#endif
+    }
+
+    // An unsatisfied promise completes its async_result with broken_promise, or fails through the terminate
+    // handler when ExceptionType cannot hold one.
+    template<typename ValueType, typename ExceptionType>
+    class promise {
+    public:
+        using result_type = result<ValueType, ExceptionType>;
+
+        promise():
+                m_node(_a::make<_a::promise_node<result_type>>(nullptr)),
+                m_retrieved(false),
+                m_satisfied(false)
+        {}
+
+        promise(promise &&other) noexcept:
+                m_node(other.m_node),
+                m_retrieved(other.m_retrieved),
+                m_satisfied(other.m_satisfied)
+        {
+            other.m_node = nullptr;
+        }
+
+        promise(const promise &) = delete;
+        promise& operator=(const promise &) = delete;
+
+        ~promise() {
+            if (!m_node)
+                return;
+            if (!m_satisfied) {
+                m_node->complete(_a::broken<result_type>());
+                m_node->release();
+            }
+            if (!m_retrieved)
+                m_node->release();
+        }
+
+        async_result<ValueType, ExceptionType> get_async_result() {
+            if (!m_node || m_retrieved)
+                _e::raise<std::logic_error>("opex::promise result already retrieved");
+            m_retrieved = true;
+            return _a::access::wrap<async_result<ValueType, ExceptionType>>(m_node);
+        }
+
+        void set_result(result_type &&r) {
+            if (!m_node || m_satisfied)
+                _e::raise<std::logic_error>("opex::promise already satisfied");
+            m_satisfied = true;
+            m_node->complete(std::move(r));
+            m_node->release();
+        }
+
+        void set_value(const ValueType &value) { set_result(result_type{value}); }
+        void set_value(ValueType &&value) { set_result(result_type{std::move(value)}); }
+
+        template<typename NewExceptionType, typename... ArgTypes>
+        void set_exception(ArgTypes &&... args) {
+            set_result(result_type::template make_exception<NewExceptionType>(std::forward<ArgTypes>(args)...));
+        }
+
+    private:
+        _a::node<result_type> *m_node;
+        bool m_retrieved;
+        bool m_satisfied;
+    };
+
+    // Runs func on ex with result::call semantics.
+    template<typename ExceptionType = std::exception, typename Func,
+             typename ValueType = _t::call_result_t<typename std::decay<Func>::type&>>
+    async_result<ValueType, ExceptionType> async(executor &ex, Func &&func) {
+        using result_type = result<ValueType, ExceptionType>;
+        using source_type = _a::source<result_type, typename std::decay<Func>::type>;
+
+        const auto s = _a::make<source_type>(nullptr, typename std::decay<Func>::type(std::forward<Func>(func)));
+        auto chained = _a::access::wrap<async_result<ValueType, ExceptionType>>(static_cast<_a::node<result_type>*>(s));
+        ex.post(*s);
+        return chained;
+    }
+}
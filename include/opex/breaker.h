@@ -0,0 +1,232 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#include <opex/opex.h>
+
+namespace opex {
+    class circuit_open : public std::runtime_error {
+    public:
+        circuit_open(): std::runtime_error("opex::circuit_breaker open") {}
+    };
+
+    namespace _b {
+        // Counters carry the bucket epoch in their upper half, so a stale bucket is recycled by whichever
+        // thread first counts into it, without a lock or a separate reset step. A sample that arrives late with
+        // an older epoch than the bucket already holds is dropped rather than wiping the newer counts.
+        class counter {
+        public:
+            counter(): m_word(0) {}
+
+            void add(std::uint32_t epoch) noexcept {
+                auto word = m_word.load(std::memory_order_relaxed);
+                for (;;) {
+                    const auto stored = static_cast<std::uint32_t>(word >> 32);
+                    std::uint64_t next;
+                    if (stored == epoch)
+                        next = word + 1;
+                    else if (static_cast<std::uint32_t>(word) == 0 || static_cast<std::int32_t>(epoch - stored) > 0)
+                        next = std::uint64_t(epoch) << 32 | 1;
+                    else
+                        return;
+                    if (m_word.compare_exchange_weak(word, next, std::memory_order_relaxed))
+                        return;
+                }
+            }
+
+            std::uint32_t count(std::uint32_t oldest, std::uint32_t newest) const noexcept {
+                const auto word = m_word.load(std::memory_order_relaxed);
+                const auto epoch = static_cast<std::uint32_t>(word >> 32);
+                return epoch - oldest <= newest - oldest ? static_cast<std::uint32_t>(word) : 0;
+            }
+
+        private:
+            std::atomic<std::uint64_t> m_word;
+        };
+
+        struct bucket {
+            counter ok;
+            counter failed;
+        };
+
+        template<typename ExceptionType>
+        const _e::error_ptr& open_error() {
+            static const _e::error_ptr s_error = _e::make_error_ptr<ExceptionType>(circuit_open{});
+            return s_error;
+        }
+    }
+
+    // Wraps opex::call. While closed, outcomes are counted in a sliding window of buckets; when the share of
+    // errors crosses failure_threshold (after minimum_calls), the breaker opens and calls fail fast with a
+    // shared circuit_open error. After open_for it lets up to probes calls through; a successful probe
+    // closes it with a fresh window, a failed one opens it again.
+    template<typename Clock = std::chrono::steady_clock>
+    class circuit_breaker {
+    public:
+        using duration = typename Clock::duration;
+
+        enum class state { closed, open, half_open };
+
+        struct options {
+            double failure_threshold = 0.5;
+            std::uint32_t minimum_calls = 20;
+            duration window = std::chrono::seconds(10);
+            std::size_t buckets = 10;
+            duration open_for = std::chrono::seconds(5);
+            std::uint32_t probes = 1;
+        };
+
+        explicit circuit_breaker(const options &o = options{}):
+                m_options(o),
+                m_bucket_width(o.window / static_cast<typename duration::rep>(o.buckets < 1 ? 1 : o.buckets)),
+                m_buckets(new _b::bucket[o.buckets < 1 ? 1 : o.buckets]),
+                m_state(closed),
+                m_opened_at(0),
+                m_probes(0),
+                m_window_start(0)
+        {
+            if (m_bucket_width <= duration::zero())
+                _e::raise<std::invalid_argument>("opex::circuit_breaker window must span at least one tick per bucket");
+        }
+
+        circuit_breaker(const circuit_breaker &) = delete;
+        circuit_breaker& operator=(const circuit_breaker &) = delete;
+
+        template<typename ExceptionType = std::exception, typename Func,
+                 typename ValueType = _t::call_result_t<Func>>
+        result<ValueType, ExceptionType> call(Func &&func) {
+            static_assert(std::is_base_of<ExceptionType, circuit_open>::value,
+                          "circuit_breaker results must be able to hold circuit_open");
+            using result_type = result<ValueType, ExceptionType>;
+
+            const auto now = Clock::now();
+            auto s = m_state.load(std::memory_order_acquire);
+            if (s == open || s == opening) {
+                if (s == opening ||
+                    now.time_since_epoch().count() - m_opened_at.load(std::memory_order_relaxed) < m_options.open_for.count())
+                    return _t::access::from_exception_ptr<result_type>(_b::open_error<ExceptionType>());
+                if (m_state.compare_exchange_strong(s, half_open, std::memory_order_acq_rel))
+                    s = half_open;
+            }
+
+            if (s == half_open) {
+                if (m_probes.fetch_add(1, std::memory_order_acq_rel) >= m_options.probes) {
+                    m_probes.fetch_sub(1, std::memory_order_acq_rel);
+                    return _t::access::from_exception_ptr<result_type>(_b::open_error<ExceptionType>());
+                }
+                probe p{*this, false};
+                auto r = result_type::call(std::forward<Func>(func));
+                p.succeeded = r.is_ok();
+                return r;
+            }
+
+            sample smp{*this, false};
+            auto r = result_type::call(std::forward<Func>(func));
+            smp.succeeded = r.is_ok();
+            return r;
+        }
+
+        state current_state() const noexcept {
+            const auto s = m_state.load(std::memory_order_acquire);
+            return s == opening ? state::open : static_cast<state>(s);
+        }
+
+        // Share of errors among the calls in the current window, or 0 when it holds none.
+        double error_rate() const noexcept {
+            std::uint32_t ok, failed;
+            tally(Clock::now(), ok, failed);
+            return ok + failed ? double(failed) / (ok + failed) : 0.0;
+        }
+
+    private:
+        // opening is open while the time it opened is still being written.
+        enum : int { closed = int(state::closed), open = int(state::open), half_open = int(state::half_open), opening };
+
+        // Records the outcome of a closed-state call when it completes; a call that throws past result::call
+        // counts as failed. A slow failure lands in the window, and trips the breaker, at the time it is seen.
+        struct sample {
+            ~sample() { owner.record(Clock::now(), succeeded); }
+
+            circuit_breaker &owner;
+            bool succeeded;
+        };
+
+        struct probe {
+            ~probe() { owner.settle_probe(succeeded); }
+
+            circuit_breaker &owner;
+            bool succeeded;
+        };
+
+        std::uint32_t epoch_of(typename Clock::time_point t) const noexcept {
+            return static_cast<std::uint32_t>(t.time_since_epoch() / m_bucket_width);
+        }
+
+        void tally(typename Clock::time_point now, std::uint32_t &ok, std::uint32_t &failed) const noexcept {
+            const auto newest = epoch_of(now);
+            const auto n = static_cast<std::uint32_t>(bucket_count());
+            auto oldest = newest - (n - 1);
+            const auto start = m_window_start.load(std::memory_order_acquire);
+            if (newest - start < newest - oldest)
+                oldest = start;
+
+            ok = failed = 0;
+            for (std::size_t i = 0; i < bucket_count(); ++i) {
+                ok += m_buckets[i].ok.count(oldest, newest);
+                failed += m_buckets[i].failed.count(oldest, newest);
+            }
+        }
+
+        void record(typename Clock::time_point at, bool succeeded) noexcept {
+            const auto epoch = epoch_of(at);
+            auto &b = m_buckets[epoch % bucket_count()];
+            if (succeeded) {
+                b.ok.add(epoch);
+                return;
+            }
+            b.failed.add(epoch);
+
+            std::uint32_t ok, failed;
+            tally(at, ok, failed);
+            if (ok + failed >= m_options.minimum_calls && failed >= m_options.failure_threshold * (ok + failed))
+                trip(closed);
+        }
+
+        void settle_probe(bool succeeded) noexcept {
+            const auto now = Clock::now();
+            if (succeeded) {
+                m_window_start.store(epoch_of(now), std::memory_order_release);
+                int expected = half_open;
+                m_state.compare_exchange_strong(expected, closed, std::memory_order_acq_rel);
+            } else {
+                trip(half_open);
+            }
+            m_probes.fetch_sub(1, std::memory_order_acq_rel);
+        }
+
+        // The cool-down runs from the moment the breaker opens. Only the transition stamps the time, so failures
+        // recorded while already open (calls that started before the trip) cannot push its end back.
+        void trip(int from) noexcept {
+            if (m_state.compare_exchange_strong(from, opening, std::memory_order_acq_rel)) {
+                m_opened_at.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+                m_state.store(open, std::memory_order_release);
+            }
+        }
+
+        std::size_t bucket_count() const noexcept { return m_options.buckets < 1 ? 1 : m_options.buckets; }
+
+        const options m_options;
+        const duration m_bucket_width;
+        std::unique_ptr<_b::bucket[]> m_buckets;
+        std::atomic<int> m_state;
+        std::atomic<typename duration::rep> m_opened_at;
+        std::atomic<std::uint32_t> m_probes;
+        std::atomic<std::uint32_t> m_window_start;
+    };
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+#include <opex/opex.h>
+
+namespace opex {
+    class channel_closed : public std::runtime_error {
+    public:
+        channel_closed(): std::runtime_error("opex::result_channel closed") {}
+    };
+
+    namespace _ch {
+        constexpr std::size_t cache_line = 64;
+
+        inline std::size_t round_up_pow2(std::size_t n) {
+            std::size_t p = 1;
+            while (p < n)
+                p <<= 1;
+            return p;
+        }
+    }
+
+    // Bounded ring of results for any number of producers and a single consumer.
+    template<typename ValueType, typename ExceptionType = std::exception>
+    class result_channel {
+    public:
+        using result_type = result<ValueType, ExceptionType>;
+
+        explicit result_channel(std::size_t capacity):
+                m_mask(_ch::round_up_pow2(capacity < 2 ? 2 : capacity) - 1),
+                m_memory(new unsigned char[(m_mask + 1) * sizeof(slot) + _ch::cache_line]),
+                m_tail(0),
+                m_final(nullptr),
+                m_head(0),
+                m_finished(false)
+        {
+            void *p = m_memory.get();
+            std::size_t space = (m_mask + 1) * sizeof(slot) + _ch::cache_line;
+            m_slots = static_cast<slot*>(std::align(_ch::cache_line, (m_mask + 1) * sizeof(slot), p, space));
+            for (std::size_t i = 0; i <= m_mask; ++i)
+                new(&m_slots[i]) slot(i);
+        }
+
+        result_channel(const result_channel &) = delete;
+        result_channel& operator=(const result_channel &) = delete;
+
+        ~result_channel() {
+            while (try_pop([](result_type &&) {}))
+                ;
+            for (std::size_t i = 0; i <= m_mask; ++i)
+                m_slots[i].~slot();
+            delete m_final.load(std::memory_order_acquire);
+        }
+
+        std::size_t capacity() const noexcept { return m_mask + 1; }
+
+        bool is_closed() const noexcept { return (m_tail.load(std::memory_order_acquire) & closed_bit) != 0; }
+
+        bool try_push(result_type &&r) {
+            std::size_t pos;
+            if (!claim(1, pos))
+                return false;
+            publish(pos, std::move(r));
+            return true;
+        }
+
+        template<typename InputIt>
+        InputIt try_push_batch(InputIt first, InputIt last) {
+            auto n = static_cast<std::size_t>(std::distance(first, last));
+            if (n > capacity())
+                n = capacity();
+
+            std::size_t pos;
+            while (n > 0 && !claim(n, pos))
+                n /= 2;
+
+            for (std::size_t i = 0; i < n; ++i, ++first)
+                publish(pos + i, std::move(*first));
+            return first;
+        }
+
+        bool close() {
+            return close(result_type::template make_exception<channel_closed>());
+        }
+
+        bool close(result_type &&final_error) {
+            if (final_error.is_ok())
+                _e::raise<std::invalid_argument>("opex::result_channel must be closed with an error");
+
+            auto final = new result_type(std::move(final_error));
+            result_type *expected = nullptr;
+            if (!m_final.compare_exchange_strong(expected, final, std::memory_order_acq_rel)) {
+                delete final;
+                return false;
+            }
+            m_tail.fetch_or(closed_bit, std::memory_order_acq_rel);
+            return true;
+        }
+
+        // Consumer side: Func is called with a result_type&& for the next item. Once the channel is
+        // closed and drained, the final error is delivered exactly once and finished() turns true.
+        template<typename Func>
+        bool try_pop(Func &&consumer) {
+            if (m_finished)
+                return false;
+
+            auto &s = m_slots[m_head & m_mask];
+            if (s.seq.load(std::memory_order_acquire) == m_head + 1) {
+                auto r = take(s);
+                s.seq.store(m_head + m_mask + 1, std::memory_order_release);
+                ++m_head;
+                consumer(std::move(r));
+                return true;
+            }
+
+            const auto tail = m_tail.load(std::memory_order_acquire);
+            if ((tail & closed_bit) && (tail & ~closed_bit) == m_head) {
+                m_finished = true;
+                consumer(_t::access::copy_error(*m_final.load(std::memory_order_acquire)));
+                return true;
+            }
+            return false;
+        }
+
+        template<typename Func>
+        std::size_t try_pop_batch(Func &&consumer, std::size_t max) {
+            std::size_t n = 0;
+            while (n < max && try_pop(consumer))
+                ++n;
+            return n;
+        }
+
+        bool finished() const noexcept { return m_finished; }
+
+    private:
+        static constexpr std::size_t closed_bit = ~(~std::size_t(0) >> 1);
+
+        struct alignas(_ch::cache_line) slot {
+            explicit slot(std::size_t i): seq(i), error(nullptr) {}
+
+            std::atomic<std::size_t> seq;
+            result_type *error;
+            typename std::aligned_storage<sizeof(ValueType), alignof(ValueType)>::type value;
+        };
+
+        bool claim(std::size_t n, std::size_t &pos) noexcept {
+            pos = m_tail.load(std::memory_order_relaxed);
+            for (;;) {
+                if (pos & closed_bit)
+                    return false;
+
+                const auto seq = m_slots[(pos + n - 1) & m_mask].seq.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::ptrdiff_t>(seq - (pos + n - 1));
+                if (diff == 0) {
+                    if (m_tail.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed))
+                        return true;
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = m_tail.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        void publish(std::size_t pos, result_type &&r) {
+            auto &s = m_slots[pos & m_mask];
+            if (r.is_ok()) {
+                new(&s.value) ValueType(std::move(r).unwrap());
+                s.error = nullptr;
+            } else {
+                s.error = new result_type(std::move(r));
+            }
+            s.seq.store(pos + 1, std::memory_order_release);
+        }
+
+        static result_type take(slot &s) {
+            if (s.error) {
+                std::unique_ptr<result_type> error(s.error);
+                s.error = nullptr;
+                return std::move(*error);
+            }
+
+            auto &value = *reinterpret_cast<ValueType*>(&s.value);
+            result_type r{std::move(value)};
+            value.~ValueType();
+            return r;
+        }
+
+        const std::size_t m_mask;
+        std::unique_ptr<unsigned char[]> m_memory;
+        slot *m_slots;
+
+        alignas(_ch::cache_line) std::atomic<std::size_t> m_tail;
+        std::atomic<result_type*> m_final;
+
+        alignas(_ch::cache_line) std::size_t m_head;
+        bool m_finished;
+    };
+}
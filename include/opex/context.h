@@ -0,0 +1,20 @@
+#pragma once
+
+#include <sstream>
+#include <string>
+
+#include <opex/opex.h>
+
+namespace opex {
+    namespace _ctx {
+        // Context arguments that opex.h does not render itself go through their operator<<.
+        template<typename T, typename>
+        struct renderer {
+            static void append(std::string &out, const T &value) {
+                std::ostringstream os;
+                os << value;
+                out += os.str();
+            }
+        };
+    }
+}
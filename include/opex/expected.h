@@ -0,0 +1,290 @@
+#pragma once
+
+#include <version>
+
+#if !defined(__cpp_lib_expected) || __cpp_lib_expected < 202202L
+#error "opex/expected.h needs std::expected (C++23)"
+#endif
+
+#include <exception>
+#include <expected>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include <opex/opex.h>
+
+namespace opex {
+    // The error half of a result, as the unexpected type of a std::expected. It holds the same error handle
+    // the result did, context included, and remembers the exception type the result was declared with so the
+    // way back is checked at compile time.
+    template<typename ExceptionType = std::exception, typename ErrorHandle = shared_error_handle>
+    class error {
+    public:
+        using exception_type = ExceptionType;
+        using error_handle = ErrorHandle;
+        using result_type = result<std::monostate, ExceptionType, ErrorHandle>;
+
+        explicit error(result_type &&r) noexcept: m_result(std::move(r)) {}
+
+        std::string what() const noexcept { return m_result.what(); }
+        std::string diagnostic() const noexcept { return m_result.diagnostic(); }
+
+        template<typename Func>
+        decltype(auto) visit(Func &&func) const& { return m_result.err_visit(std::forward<Func>(func)); }
+
+        template<typename Func>
+        decltype(auto) visit(Func &&func) && { return std::move(m_result).err_visit(std::forward<Func>(func)); }
+
+        result_type& as_result() & noexcept { return m_result; }
+        result_type&& as_result() && noexcept { return std::move(m_result); }
+
+    private:
+        result_type m_result;
+    };
+
+    template<typename ValueType, typename ExceptionType = std::exception, typename ErrorHandle = shared_error_handle>
+    using expected = std::expected<ValueType, error<ExceptionType, ErrorHandle>>;
+
+    // Both directions move the value or the error handle across; the stored exception is never rethrown.
+    template<typename ValueType, typename ExceptionType, typename ErrorHandle>
+    expected<ValueType, ExceptionType, ErrorHandle> to_expected(result<ValueType, ExceptionType, ErrorHandle> &&r) {
+        using error_type = error<ExceptionType, ErrorHandle>;
+
+        if (OPEX_LIKELY(r.is_ok()))
+            return expected<ValueType, ExceptionType, ErrorHandle>{std::in_place, _t::access::value(std::move(r))};
+        return expected<ValueType, ExceptionType, ErrorHandle>{
+                std::unexpect, _t::access::error_as<typename error_type::result_type>(std::move(r))};
+    }
+
+    template<typename ValueType, typename ExceptionType, typename ErrorHandle>
+    result<ValueType, ExceptionType, ErrorHandle> from_expected(expected<ValueType, ExceptionType, ErrorHandle> &&e) {
+        using result_type = result<ValueType, ExceptionType, ErrorHandle>;
+
+        if (OPEX_LIKELY(e.has_value()))
+            return result_type{std::move(*e)};
+        return _t::access::error_as<result_type>(std::move(e.error()).as_result());
+    }
+
+    // Any other std::expected whose error is an exception object: the error is moved into a new handle.
+    template<typename ExceptionType = std::exception, typename ValueType, typename E,
+             _t::enable_if_t<std::is_base_of<ExceptionType, E>::value>* = nullptr>
+    result<ValueType, ExceptionType> from_expected(std::expected<ValueType, E> &&e) {
+        using result_type = result<ValueType, ExceptionType>;
+
+        if (OPEX_LIKELY(e.has_value()))
+            return result_type{std::move(*e)};
+        return result_type::from_exception(std::move(e.error()));
+    }
+
+    // Error handle for results that keep their error by value. result<V, E, value_error> is a thin layer over
+    // std::expected<V, E>: no exception_ptr, no refcount and no context frames, so it has the same size and
+    // trivial special members as the std::expected it wraps and works in constant expressions. E can be any
+    // value type, an enum or std::error_code as well as an exception class, which is then stored as declared
+    // (a derived object would be sliced).
+    struct value_error {};
+
+    template<typename ValueType, typename ErrorType>
+    using value_result = result<ValueType, ErrorType, value_error>;
+
+    namespace _x {
+        template<typename T> struct is_value_result : std::false_type {};
+        template<typename V, typename E> struct is_value_result<result<V, E, value_error>> : std::true_type {};
+
+        template<typename E>
+        [[noreturn]] OPEX_COLD void raise(const E &error) {
+#ifdef OPEX_NO_EXCEPTIONS
+            if constexpr (std::is_base_of_v<std::exception, E>)
+                _e::fail(error.what());
+            else
+                _e::fail("unwrap called on an error'd value_result");
+#else
+            if constexpr (std::is_base_of_v<std::exception, E>)
+                throw error;
+            else
+                throw std::bad_expected_access<E>(error);
+#endif
+        }
+    }
+
+    template<typename ValueType, typename ErrorType>
+    class result<ValueType, ErrorType, value_error> {
+    public:
+        using value_type = ValueType;
+        using exception_type = ErrorType;
+        using error_type = ErrorType;
+        using error_handle = value_error;
+        using expected_type = std::expected<ValueType, ErrorType>;
+
+        template<typename F, typename Arg>
+        using rebind_value_t = result<_t::call_result_t<F, Arg>, ErrorType, value_error>;
+
+        template<typename F, typename Arg>
+        using rebind_error_t = result<ValueType, std::remove_cvref_t<_t::call_result_t<F, Arg>>, value_error>;
+
+        constexpr explicit result(const ValueType &value): m_expected(std::in_place, value) {}
+        constexpr explicit result(ValueType &&value): m_expected(std::in_place, std::move(value)) {}
+        constexpr explicit result(expected_type expected): m_expected(std::move(expected)) {}
+
+        template<typename... Args>
+        static constexpr result make_error(Args &&... args) {
+            return result{expected_type{std::unexpect, std::forward<Args>(args)...}};
+        }
+
+        // Spellings of the exception backend, so code written against either compiles with both.
+        template<typename E, typename... Args>
+        static constexpr result make_exception(Args... args) {
+            static_assert(std::is_same_v<E, ErrorType>, "a value_result stores exactly its declared error type");
+            return make_error(E{std::forward<Args>(args)...});
+        }
+
+        template<typename E>
+        static constexpr result from_exception(E &&error) {
+            static_assert(std::is_same_v<std::remove_cvref_t<E>, ErrorType>, "a value_result stores exactly its declared error type");
+            return make_error(std::forward<E>(error));
+        }
+
+        // Catches the declared error type when it is a class; anything else propagates.
+        template<typename Func>
+        static constexpr result call(Func &&func) {
+#ifndef OPEX_NO_EXCEPTIONS
+            if constexpr (std::is_class_v<ErrorType>) {
+                try {
+                    return result{func()};
+                } catch (const ErrorType &error) {
+                    return make_error(error);
+                }
+            }
+#endif
+            return result{func()};
+        }
+
+        constexpr bool is_ok() const noexcept  { return m_expected.has_value(); }
+        constexpr bool is_err() const noexcept { return !m_expected.has_value(); }
+
+        constexpr explicit operator bool() const noexcept { return is_ok(); }
+        constexpr bool operator!() const noexcept         { return is_err(); }
+
+        constexpr const ValueType&  unwrap() const& { throw_on_err(); return *m_expected; }
+        constexpr       ValueType&  unwrap() &      { throw_on_err(); return *m_expected; }
+        constexpr       ValueType&& unwrap() &&     { throw_on_err(); return std::move(*m_expected); }
+
+        constexpr const ValueType* operator->() const { return &unwrap(); }
+        constexpr       ValueType* operator->()       { return &unwrap(); }
+        constexpr const ValueType&  operator*() const& { return unwrap(); }
+        constexpr       ValueType&  operator*() &      { return unwrap(); }
+        constexpr       ValueType&& operator*() &&     { return std::move(*this).unwrap(); }
+
+        constexpr const ErrorType&  error() const& { check_err(); return m_expected.error(); }
+        constexpr       ErrorType&& error() &&     { check_err(); return std::move(m_expected.error()); }
+
+        template<typename Func>
+        constexpr decltype(auto) err_visit(Func &&func) const& { return func(error()); }
+
+        template<typename Func>
+        constexpr decltype(auto) err_visit(Func &&func) && { return func(std::move(*this).error()); }
+
+        constexpr const expected_type& as_expected() const& noexcept { return m_expected; }
+        constexpr       expected_type&& as_expected() && noexcept    { return std::move(m_expected); }
+
+        template<typename Func, typename ResultType = rebind_value_t<Func, const ValueType &>>
+        constexpr ResultType map(Func &&func) const& {
+            return OPEX_LIKELY(is_ok()) ? ResultType{func(*m_expected)} : ResultType::make_error(m_expected.error());
+        }
+
+        template<typename Func, typename ResultType = rebind_value_t<Func, ValueType &&>>
+        constexpr ResultType map(Func &&func) && {
+            return OPEX_LIKELY(is_ok()) ? ResultType{func(std::move(*m_expected))}
+                                        : ResultType::make_error(std::move(m_expected.error()));
+        }
+
+        template<typename Func, typename ResultType = rebind_error_t<Func, const ErrorType &>>
+        constexpr ResultType map_err(Func &&func) const& {
+            return OPEX_LIKELY(is_ok()) ? ResultType{*m_expected} : ResultType::make_error(func(m_expected.error()));
+        }
+
+        template<typename Func, typename ResultType = rebind_error_t<Func, ErrorType &&>>
+        constexpr ResultType map_err(Func &&func) && {
+            return OPEX_LIKELY(is_ok()) ? ResultType{std::move(*m_expected)}
+                                        : ResultType::make_error(func(std::move(m_expected.error())));
+        }
+
+        template<typename Func, typename ResultType = std::remove_cvref_t<_t::call_result_t<Func, const ValueType &>>>
+        constexpr ResultType and_then(Func &&func) const& {
+            static_assert(_x::is_value_result<ResultType>::value && std::is_same_v<typename ResultType::error_type, ErrorType>,
+                          "and_then must return a value_result with the same error type");
+            return OPEX_LIKELY(is_ok()) ? func(*m_expected) : ResultType::make_error(m_expected.error());
+        }
+
+        template<typename Func, typename ResultType = std::remove_cvref_t<_t::call_result_t<Func, ValueType &&>>>
+        constexpr ResultType and_then(Func &&func) && {
+            static_assert(_x::is_value_result<ResultType>::value && std::is_same_v<typename ResultType::error_type, ErrorType>,
+                          "and_then must return a value_result with the same error type");
+            return OPEX_LIKELY(is_ok()) ? func(std::move(*m_expected)) : ResultType::make_error(std::move(m_expected.error()));
+        }
+
+        template<typename Func, typename ResultType = std::remove_cvref_t<_t::call_result_t<Func, const ErrorType &>>>
+        constexpr ResultType or_else(Func &&func) const& {
+            static_assert(_x::is_value_result<ResultType>::value && std::is_same_v<typename ResultType::value_type, ValueType>,
+                          "or_else must return a value_result with the same value type");
+            return OPEX_LIKELY(is_ok()) ? ResultType{*m_expected} : func(m_expected.error());
+        }
+
+        template<typename Func, typename ResultType = std::remove_cvref_t<_t::call_result_t<Func, ErrorType &&>>>
+        constexpr ResultType or_else(Func &&func) && {
+            static_assert(_x::is_value_result<ResultType>::value && std::is_same_v<typename ResultType::value_type, ValueType>,
+                          "or_else must return a value_result with the same value type");
+            return OPEX_LIKELY(is_ok()) ? ResultType{std::move(*m_expected)} : func(std::move(m_expected.error()));
+        }
+
+        constexpr const result& and_select(const result &other) const& { return is_ok() ? other : *this; }
+        constexpr const result& or_select(const result &other) const&  { return is_err() ? other : *this; }
+        constexpr result and_select(result other) &&                   { return is_ok() ? std::move(other) : std::move(*this); }
+        constexpr result or_select(result other) &&                    { return is_err() ? std::move(other) : std::move(*this); }
+
+        template<typename Func>
+        constexpr result and_select_with(Func &&func) const& { return OPEX_LIKELY(is_ok()) ? func() : *this; }
+
+        template<typename Func>
+        constexpr result or_select_with(Func &&func) const& { return is_err() ? func() : *this; }
+
+        std::string what() const {
+            if (is_ok())
+                return {};
+            if constexpr (std::is_base_of_v<std::exception, ErrorType>)
+                return m_expected.error().what();
+            else if constexpr (requires(const ErrorType &e) { e.message(); })
+                return m_expected.error().message();
+            else
+                return {};
+        }
+
+        std::string diagnostic() const { return what(); }
+
+    private:
+        constexpr void throw_on_err() const {
+            if (OPEX_UNLIKELY(is_err()))
+                _x::raise(m_expected.error());
+        }
+
+        constexpr void check_err() const {
+            if (OPEX_UNLIKELY(is_ok()))
+                _e::raise<std::logic_error>("error can only be called on error'd instances");
+        }
+
+        expected_type m_expected;
+    };
+
+    template<typename ValueType, typename ErrorType>
+    constexpr std::expected<ValueType, ErrorType> to_expected(result<ValueType, ErrorType, value_error> &&r) {
+        return std::move(r).as_expected();
+    }
+
+    // A std::expected whose error is not an exception object becomes a value_result around the same storage.
+    template<typename ValueType, typename E,
+             _t::enable_if_t<!std::is_base_of<std::exception, E>::value>* = nullptr>
+    constexpr value_result<ValueType, E> from_expected(std::expected<ValueType, E> &&e) {
+        return value_result<ValueType, E>{std::move(e)};
+    }
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include <opex/opex.h>
+
+namespace opex {
+    namespace _f {
+        constexpr std::uint64_t inherit = ~std::uint64_t(0);
+        constexpr std::uint64_t golden = 0x9e3779b97f4a7c15ull;
+
+        inline std::uint64_t mix(std::uint64_t x) noexcept {
+            x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+            x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+            return x ^ (x >> 31);
+        }
+
+        inline std::uint64_t key_of(const char *tag) noexcept {
+            std::uint64_t h = 0xcbf29ce484222325ull;
+            for (; *tag; ++tag)
+                h = (h ^ static_cast<unsigned char>(*tag)) * 0x100000001b3ull;
+            return h;
+        }
+
+        // Rates are thresholds on a 32-bit draw, so a rate of 1 is 2^32 and always fires.
+        inline std::uint64_t threshold_of(double rate) noexcept {
+            return rate <= 0 ? 0 : rate >= 1 ? std::uint64_t(1) << 32 : static_cast<std::uint64_t>(rate * 4294967296.0);
+        }
+
+        struct settings {
+            settings(): seed(0), threshold(0), generation(1) {}
+
+            std::atomic<std::uint64_t> seed;
+            std::atomic<std::uint64_t> threshold;
+            std::atomic<std::uint32_t> generation;
+        };
+
+        inline settings& global() noexcept {
+            static settings s_settings;
+            return s_settings;
+        }
+
+        // Call counters per thread and site, in an open-addressing table keyed on the full tag hash, so sites
+        // never share a sequence. Reseeding bumps the generation, which restarts every sequence.
+        class counters {
+        public:
+            counters(): m_generation(0), m_used(0), m_slots(16) {}
+
+            std::uint64_t next(std::uint64_t key, std::uint32_t generation) {
+                if (OPEX_UNLIKELY(m_generation != generation)) {
+                    m_slots.assign(m_slots.size(), slot{});
+                    m_used = 0;
+                    m_generation = generation;
+                }
+                if (OPEX_UNLIKELY(2 * (m_used + 1) > m_slots.size()))
+                    grow();
+
+                auto &s = find(m_slots, key);
+                if (!s.used) {
+                    s = slot{key, 0, true};
+                    ++m_used;
+                }
+                return s.calls++;
+            }
+
+        private:
+            struct slot {
+                std::uint64_t key;
+                std::uint64_t calls;
+                bool used;
+            };
+
+            static slot& find(std::vector<slot> &slots, std::uint64_t key) noexcept {
+                const auto mask = slots.size() - 1;
+                auto i = static_cast<std::size_t>(mix(key)) & mask;
+                while (slots[i].used && slots[i].key != key)
+                    i = (i + 1) & mask;
+                return slots[i];
+            }
+
+            OPEX_COLD void grow() {
+                std::vector<slot> bigger(2 * m_slots.size());
+                for (const auto &s : m_slots)
+                    if (s.used)
+                        find(bigger, s.key) = s;
+                m_slots.swap(bigger);
+            }
+
+            std::uint32_t m_generation;
+            std::size_t m_used;
+            std::vector<slot> m_slots;
+        };
+
+        inline bool draw(std::uint64_t key, std::uint64_t threshold) {
+            static thread_local counters s_counters;
+            const auto &g = global();
+            const auto n = s_counters.next(key, g.generation.load(std::memory_order_relaxed));
+            const auto base = g.seed.load(std::memory_order_relaxed) ^ key;
+            return (mix(base + (n + 1) * golden) >> 32) < threshold;
+        }
+    }
+
+    // Fault injection for load-testing error paths. A call made through a site fails with a copy of the site's
+    // exception at the configured rate, without running the wrapped function. Whether the n-th call on a thread
+    // fails depends only on the seed, the site's tag and n, so runs replay exactly. Injection is compiled in
+    // with OPEX_FAULT_INJECTION; without it sites are inert and calls through them go straight to the function.
+    // Sites are declared in an inline namespace named after the setting (see OPEX_FAULT_ABI). A program can
+    // therefore mix translation units built either way, but only if no site is passed between them.
+    namespace fault {
+#ifdef OPEX_FAULT_INJECTION
+        constexpr bool enabled = true;
+#else
+        constexpr bool enabled = false;
+#endif
+
+        inline void set_seed(std::uint64_t seed) noexcept {
+            _f::global().seed.store(seed, std::memory_order_relaxed);
+            _f::global().generation.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Rate for sites that have not been given their own.
+        inline void set_rate(double rate) noexcept {
+            _f::global().threshold.store(_f::threshold_of(rate), std::memory_order_relaxed);
+        }
+
+        inline namespace OPEX_FAULT_ABI {
+            template<typename ExceptionType>
+            class site {
+            public:
+                template<typename... Args>
+                explicit site(const char *tag, Args &&... args):
+                        m_tag(tag),
+                        m_key(_f::key_of(tag)),
+                        m_threshold(_f::inherit),
+                        m_fault(std::forward<Args>(args)...)
+                {}
+
+                site(const site &) = delete;
+                site& operator=(const site &) = delete;
+
+                const char* tag() const noexcept { return m_tag; }
+
+                void set_rate(double rate) noexcept {
+                    m_threshold.store(_f::threshold_of(rate), std::memory_order_relaxed);
+                }
+                void clear_rate() noexcept { m_threshold.store(_f::inherit, std::memory_order_relaxed); }
+
+                // Sites at rate 0 do not draw, so switching one off leaves the sequences of the others untouched.
+                bool fire() const {
+                    auto threshold = m_threshold.load(std::memory_order_relaxed);
+                    if (threshold == _f::inherit)
+                        threshold = _f::global().threshold.load(std::memory_order_relaxed);
+                    return threshold != 0 && _f::draw(m_key, threshold);
+                }
+
+                template<typename Base>
+                OPEX_COLD _e::error_ptr make_error() const {
+                    return _e::make_error_ptr<Base>(m_fault);
+                }
+
+            private:
+                const char *m_tag;
+                std::uint64_t m_key;
+                std::atomic<std::uint64_t> m_threshold;
+                ExceptionType m_fault;
+            };
+        }
+    }
+
+    template<typename ExceptionType = std::exception, typename FaultType, typename Func,
+              typename ValueType = _t::call_result_t<Func>>
+    result<ValueType, ExceptionType> call(const fault::site<FaultType> &site, Func &&func) {
+        return result<ValueType, ExceptionType>::call(site, std::forward<Func>(func));
+    };
+}
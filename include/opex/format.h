@@ -0,0 +1,221 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <opex/opex.h>
+
+namespace opex {
+    namespace _fmt {
+        enum class tag : unsigned char {
+            signed_integer, unsigned_integer, floating, boolean, character, string, pointer
+        };
+
+        template<std::size_t Capacity>
+        class buffer {
+        public:
+            buffer() noexcept: m_used(0), m_count(0), m_truncated(false) {}
+
+            void put_format(const char *format) noexcept {
+                put_bytes(format, std::strlen(format));
+            }
+
+            template<typename T>
+            void put(const T &value) noexcept { put_arg(value); }
+
+            std::string render() const {
+                std::size_t pos = 0;
+                const auto format_length = get<std::size_t>(pos);
+                const auto format = reinterpret_cast<const char*>(m_data + pos);
+                pos += format_length;
+
+                std::string out;
+                out.reserve(format_length + 16 * m_count);
+
+                unsigned consumed = 0;
+                for (std::size_t i = 0; i < format_length; ++i) {
+                    const auto c = format[i];
+                    if (c == '{' && i + 1 < format_length && format[i + 1] == '{') {
+                        out += '{';
+                        ++i;
+                    } else if (c == '}' && i + 1 < format_length && format[i + 1] == '}') {
+                        out += '}';
+                        ++i;
+                    } else if (c == '{' && i + 1 < format_length && format[i + 1] == '}') {
+                        if (consumed < m_count) {
+                            render_arg(out, pos);
+                            ++consumed;
+                        } else {
+                            out += "{}";
+                        }
+                        ++i;
+                    } else {
+                        out += c;
+                    }
+                }
+
+                if (m_truncated)
+                    out += "...";
+                return out;
+            }
+
+        private:
+            template<typename T>
+            bool put_raw(const T &value) noexcept {
+                if (m_used + sizeof(T) > Capacity) {
+                    m_truncated = true;
+                    return false;
+                }
+                std::memcpy(m_data + m_used, &value, sizeof(T));
+                m_used += sizeof(T);
+                return true;
+            }
+
+            template<typename T>
+            T get(std::size_t &pos) const noexcept {
+                T value;
+                std::memcpy(&value, m_data + pos, sizeof(T));
+                pos += sizeof(T);
+                return value;
+            }
+
+            void put_bytes(const char *p, std::size_t n) noexcept {
+                if (m_used + sizeof(std::size_t) > Capacity) {
+                    m_truncated = true;
+                    return;
+                }
+                if (m_used + sizeof(std::size_t) + n > Capacity) {
+                    n = Capacity - m_used - sizeof(std::size_t);
+                    m_truncated = true;
+                }
+                put_raw(n);
+                std::memcpy(m_data + m_used, p, n);
+                m_used += n;
+            }
+
+            void put_tagged(tag t) noexcept {
+                put_raw(t);
+            }
+
+            template<typename T>
+            void put_value(tag t, const T &value) noexcept {
+                if (m_truncated || m_used + 1 + sizeof(T) > Capacity) {
+                    m_truncated = true;
+                    return;
+                }
+                put_tagged(t);
+                put_raw(value);
+                ++m_count;
+            }
+
+            void put_arg(bool b) noexcept { put_value(tag::boolean, b); }
+            void put_arg(char c) noexcept { put_value(tag::character, c); }
+
+            template<typename T, _t::enable_if_t<std::is_integral<T>::value && std::is_signed<T>::value>* = nullptr>
+            void put_arg(T i) noexcept { put_value(tag::signed_integer, static_cast<long long>(i)); }
+
+            template<typename T, _t::enable_if_t<std::is_integral<T>::value && std::is_unsigned<T>::value>* = nullptr>
+            void put_arg(T i) noexcept { put_value(tag::unsigned_integer, static_cast<unsigned long long>(i)); }
+
+            template<typename T, _t::enable_if_t<std::is_floating_point<T>::value>* = nullptr>
+            void put_arg(T d) noexcept { put_value(tag::floating, static_cast<double>(d)); }
+
+            void put_arg(const void *p) noexcept { put_value(tag::pointer, p); }
+
+            void put_arg(const char *s) noexcept { put_string(s, std::strlen(s)); }
+            void put_arg(const std::string &s) noexcept { put_string(s.data(), s.size()); }
+
+            void put_string(const char *s, std::size_t n) noexcept {
+                if (m_truncated || m_used + 1 + sizeof(std::size_t) > Capacity) {
+                    m_truncated = true;
+                    return;
+                }
+                put_tagged(tag::string);
+                put_bytes(s, n);
+                ++m_count;
+            }
+
+            void render_arg(std::string &out, std::size_t &pos) const {
+                char scratch[32];
+                switch (get<tag>(pos)) {
+                    case tag::signed_integer:
+                        out += std::to_string(get<long long>(pos));
+                        break;
+                    case tag::unsigned_integer:
+                        out += std::to_string(get<unsigned long long>(pos));
+                        break;
+                    case tag::floating:
+                        std::snprintf(scratch, sizeof(scratch), "%g", get<double>(pos));
+                        out += scratch;
+                        break;
+                    case tag::boolean:
+                        out += get<bool>(pos) ? "true" : "false";
+                        break;
+                    case tag::character:
+                        out += get<char>(pos);
+                        break;
+                    case tag::string: {
+                        const auto n = get<std::size_t>(pos);
+                        out.append(reinterpret_cast<const char*>(m_data + pos), n);
+                        pos += n;
+                        break;
+                    }
+                    case tag::pointer:
+                        std::snprintf(scratch, sizeof(scratch), "%p", get<const void*>(pos));
+                        out += scratch;
+                        break;
+                }
+            }
+
+            unsigned char m_data[Capacity];
+            std::size_t m_used;
+            unsigned m_count;
+            bool m_truncated;
+        };
+
+        template<typename Base, _t::enable_if_t<std::is_constructible<Base, const std::string &>::value>* = nullptr>
+        Base make_base() { return Base{std::string{}}; }
+
+        template<typename Base, _t::enable_if_t<!std::is_constructible<Base, const std::string &>::value>* = nullptr>
+        Base make_base() { return Base{}; }
+    }
+
+    template<typename Base = std::runtime_error, std::size_t Capacity = 128>
+    class formatted_error : public Base {
+        static_assert(std::is_base_of<std::exception, Base>::value,
+                      "formatted_error needs a std::exception derived base to override what()");
+        static_assert(Capacity >= sizeof(std::size_t), "formatted_error needs room for at least the format length");
+
+    public:
+        template<typename... Args>
+        explicit formatted_error(const char *format, const Args &... args):
+                Base(_fmt::make_base<Base>())
+        {
+            m_buffer.put_format(format);
+            put_all(args...);
+        }
+
+        const char* what() const noexcept override {
+            return m_message.get([this] { return m_buffer.render(); }, "opex::formatted_error");
+        }
+
+    private:
+        void put_all() noexcept {}
+
+        template<typename T, typename... Ts>
+        void put_all(const T &arg, const Ts &... args) noexcept {
+            m_buffer.put(arg);
+            put_all(args...);
+        }
+
+        _fmt::buffer<Capacity> m_buffer;
+        _t::cached_string m_message;
+    };
+
+    using formatted_runtime_error = formatted_error<std::runtime_error>;
+    using formatted_logic_error = formatted_error<std::logic_error>;
+}
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <opex/aggregate.h>
+#include <opex/async.h>
+#include <opex/opex.h>
+
+namespace opex {
+    namespace _h {
+        template<typename ValueType, typename ExceptionType>
+        class state;
+    }
+
+    class cancel_token {
+    public:
+        static cancel_token never() {
+            static const std::shared_ptr<const std::atomic<bool>> s_never = std::make_shared<const std::atomic<bool>>(false);
+            return cancel_token{s_never};
+        }
+
+        bool is_cancelled() const noexcept { return m_flag->load(std::memory_order_acquire); }
+
+    private:
+        explicit cancel_token(std::shared_ptr<const std::atomic<bool>> flag): m_flag(std::move(flag)) {}
+
+        std::shared_ptr<const std::atomic<bool>> m_flag;
+
+        template<typename ValueType, typename ExceptionType>
+        friend class _h::state;
+    };
+
+    namespace _h {
+        template<typename Func>
+        auto invoke(Func &func, const cancel_token &token, int) -> decltype(func(token)) { return func(token); }
+
+        template<typename Func>
+        auto invoke(Func &func, const cancel_token &, long) -> decltype(func()) { return func(); }
+
+        template<typename Func>
+        using value_of_t = decltype(invoke(std::declval<Func&>(), std::declval<const cancel_token&>(), 0));
+
+        // Default home for attempts. A task that finds no idle worker gets a new one, up to max_workers; past
+        // that it waits in the queue for the next free worker. Workers stay around for later hedges and are
+        // joined when the pool is destroyed.
+        class worker_pool : public executor {
+        public:
+            static constexpr std::size_t default_max_workers = 256;
+
+            explicit worker_pool(std::size_t max_workers = default_max_workers):
+                    m_head(nullptr),
+                    m_tail(nullptr),
+                    m_pending(0),
+                    m_idle(0),
+                    m_max_workers(max_workers ? max_workers : 1),
+                    m_stopping(false)
+            {}
+
+            worker_pool(const worker_pool &) = delete;
+            worker_pool& operator=(const worker_pool &) = delete;
+
+            ~worker_pool() {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stopping = true;
+                }
+                m_ready.notify_all();
+                for (auto &t : m_threads)
+                    t.join();
+            }
+
+            void post(_a::task &t) override {
+                t.next = nullptr;
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (m_tail)
+                    m_tail->next = &t;
+                else
+                    m_head = &t;
+                m_tail = &t;
+
+                if (++m_pending > m_idle && m_threads.size() < m_max_workers) {
+                    m_threads.emplace_back([this] { work(); });
+                } else {
+                    lock.unlock();
+                    m_ready.notify_one();
+                }
+            }
+
+            static worker_pool& shared() {
+                static worker_pool s_pool;
+                return s_pool;
+            }
+
+        private:
+            void work() {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                for (;;) {
+                    ++m_idle;
+                    m_ready.wait(lock, [this] { return m_head != nullptr || m_stopping; });
+                    --m_idle;
+                    if (!m_head)
+                        return;
+
+                    const auto t = m_head;
+                    m_head = t->next;
+                    if (!m_head)
+                        m_tail = nullptr;
+                    --m_pending;
+
+                    lock.unlock();
+                    t->run(t);
+                    lock.lock();
+                }
+            }
+
+            std::mutex m_mutex;
+            std::condition_variable m_ready;
+            _a::task *m_head;
+            _a::task *m_tail;
+            std::size_t m_pending;
+            std::size_t m_idle;
+            const std::size_t m_max_workers;
+            bool m_stopping;
+            std::vector<std::thread> m_threads;
+        };
+
+        template<typename ValueType, typename ExceptionType>
+        class state : public std::enable_shared_from_this<state<ValueType, ExceptionType>> {
+        public:
+            using attempt_result = result<ValueType, ExceptionType>;
+
+            state() {
+                m_cancelled[0] = false;
+                m_cancelled[1] = false;
+            }
+
+            template<typename Func>
+            void launch(std::size_t attempt, Func &&func, executor &ex) {
+                const auto self = this->shared_from_this();
+                const cancel_token token{std::shared_ptr<const std::atomic<bool>>(self, &m_cancelled[attempt])};
+
+                ex.submit(std::bind([self, attempt, token](typename std::decay<Func>::type &func) {
+                    std::unique_ptr<attempt_result> outcome;
+                    std::exception_ptr escaped;
+                    try {
+                        outcome.reset(new attempt_result(attempt_result::call([&] { return _h::invoke(func, token, 0); })));
+                    } catch (...) {
+                        escaped = std::current_exception();
+                    }
+
+                    std::lock_guard<std::mutex> lock(self->m_mutex);
+                    self->m_outcome[attempt] = std::move(outcome);
+                    self->m_escaped[attempt] = std::move(escaped);
+                    self->m_finished[attempt] = true;
+                    self->m_done.notify_all();
+                }, typename std::decay<Func>::type(std::forward<Func>(func))));
+                ++m_launched;
+            }
+
+            template<typename Rep, typename Period>
+            bool wait_for(std::size_t attempt, const std::chrono::duration<Rep, Period> &delay) {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                return m_done.wait_for(lock, delay, [&] { return m_finished[attempt]; })
+                    && m_outcome[attempt] && m_outcome[attempt]->is_ok();
+            }
+
+            result<ValueType, aggregate_error> settle() {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_done.wait(lock, [&] { return winner() < 2 || finished() == m_launched; });
+
+                const auto w = winner();
+                if (w < 2) {
+                    m_cancelled[1 - w].store(true, std::memory_order_release);
+                    return result<ValueType, aggregate_error>{std::move(*m_outcome[w]).unwrap()};
+                }
+
+                for (std::size_t i = 0; i < m_launched; ++i)
+                    if (m_escaped[i])
+                        std::rethrow_exception(m_escaped[i]);
+
+                // The aggregate reads the errors later, so it becomes their only owner: the last reference to each
+                // exception is then dropped on the caller's thread rather than by a worker that outlives settle.
+                aggregate_error errors{m_launched};
+                for (std::size_t i = 0; i < m_launched; ++i) {
+                    errors.add(i, *m_outcome[i]);
+                    m_outcome[i].reset();
+                }
+                return result<ValueType, aggregate_error>::from_exception(std::move(errors));
+            }
+
+        private:
+            std::size_t winner() const noexcept {
+                for (std::size_t i = 0; i < 2; ++i)
+                    if (m_outcome[i] && m_outcome[i]->is_ok())
+                        return i;
+                return 2;
+            }
+
+            std::size_t finished() const noexcept {
+                return (m_finished[0] ? 1 : 0) + (m_finished[1] ? 1 : 0);
+            }
+
+            std::mutex m_mutex;
+            std::condition_variable m_done;
+            std::unique_ptr<attempt_result> m_outcome[2];
+            std::exception_ptr m_escaped[2];
+            bool m_finished[2] = {false, false};
+            std::atomic<bool> m_cancelled[2];
+            std::size_t m_launched = 0;
+        };
+    }
+
+    // Attempts run on ex, which needs a free worker for the backup while the primary is still running; a pool
+    // that can be exhausted by slow primaries delays backups accordingly.
+    template<typename ExceptionType = std::exception, typename Primary, typename Backup, typename Rep, typename Period,
+             typename ValueType = _h::value_of_t<Primary>>
+    result<ValueType, aggregate_error> hedge(Primary &&primary, Backup &&backup,
+                                             const std::chrono::duration<Rep, Period> &delay, executor &ex) {
+        static_assert(std::is_same<ValueType, _h::value_of_t<Backup>>::value,
+                      "hedge alternatives must produce the same value type");
+        static_assert(std::is_base_of<std::exception, ExceptionType>::value,
+                      "hedge can only aggregate std::exception derived errors");
+
+        const auto state = std::make_shared<_h::state<ValueType, ExceptionType>>();
+        state->launch(0, std::forward<Primary>(primary), ex);
+        if (!state->wait_for(0, delay))
+            state->launch(1, std::forward<Backup>(backup), ex);
+        return state->settle();
+    }
+
+    // Without an executor, attempts share a process-wide pool that grows with the number of concurrent attempts,
+    // up to worker_pool::default_max_workers threads.
+    template<typename ExceptionType = std::exception, typename Primary, typename Backup, typename Rep, typename Period,
+             typename ValueType = _h::value_of_t<Primary>>
+    result<ValueType, aggregate_error> hedge(Primary &&primary, Backup &&backup,
+                                             const std::chrono::duration<Rep, Period> &delay) {
+        return hedge<ExceptionType>(std::forward<Primary>(primary), std::forward<Backup>(backup), delay,
+                                    _h::worker_pool::shared());
+    }
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <opex/opex.h>
+
+namespace opex {
+    namespace _m {
+        constexpr std::size_t cache_line = 64;
+
+        template<typename ResultType, typename Func, typename Key,
+                 _t::enable_if_t<is_result<_t::call_result_t<Func&, const Key&>>::value>* = nullptr>
+        ResultType evaluate(Func &func, const Key &key) {
+            return func(key);
+        }
+
+        template<typename ResultType, typename Func, typename Key,
+                 _t::enable_if_t<!is_result<_t::call_result_t<Func&, const Key&>>::value>* = nullptr>
+        ResultType evaluate(Func &func, const Key &key) {
+            return ResultType::call([&] { return func(key); });
+        }
+    }
+
+    // Caches whole results per key: values for value_ttl, errors for error_ttl (zero disables caching either
+    // kind). Concurrent misses on one key share a single computation; hits hand out shared ownership.
+    template<typename Key, typename ValueType, typename ExceptionType = std::exception,
+             typename Hash = std::hash<Key>, typename Clock = std::chrono::steady_clock>
+    class memoize {
+    public:
+        using result_type = result<ValueType, ExceptionType>;
+        using handle = std::shared_ptr<const result_type>;
+        using duration = typename Clock::duration;
+
+        memoize(duration value_ttl, duration error_ttl, std::size_t shards = 16):
+                m_value_ttl(value_ttl),
+                m_error_ttl(error_ttl),
+                m_shards(shards < 1 ? 1 : shards)
+        {}
+
+        memoize(const memoize &) = delete;
+        memoize& operator=(const memoize &) = delete;
+
+        // func is called with the key and returns either a ValueType, with result::call semantics, or a
+        // result_type. If it throws anything else the exception propagates and waiters retry.
+        template<typename Func>
+        handle get(const Key &key, Func &&func) {
+            auto &s = shard_of(key);
+            for (;;) {
+                std::shared_ptr<flight> pending;
+                {
+                    std::unique_lock<std::mutex> lock(s.mutex);
+                    auto &e = s.entries[key];
+                    if (e.cached && Clock::now() < e.expires)
+                        return e.cached;
+
+                    if (!e.pending) {
+                        e.cached.reset();
+                        e.pending = std::make_shared<flight>();
+                        pending = e.pending;
+                        lock.unlock();
+                        return compute(s, key, pending, func);
+                    }
+                    pending = e.pending;
+                }
+
+                std::unique_lock<std::mutex> lock(pending->mutex);
+                pending->done.wait(lock, [&] { return pending->finished; });
+                if (pending->outcome)
+                    return pending->outcome;
+            }
+        }
+
+        handle peek(const Key &key) const {
+            auto &s = shard_of(key);
+            std::lock_guard<std::mutex> lock(s.mutex);
+            const auto it = s.entries.find(key);
+            if (it == s.entries.end() || !it->second.cached || !(Clock::now() < it->second.expires))
+                return nullptr;
+            return it->second.cached;
+        }
+
+        void invalidate(const Key &key) {
+            auto &s = shard_of(key);
+            std::lock_guard<std::mutex> lock(s.mutex);
+            const auto it = s.entries.find(key);
+            if (it != s.entries.end() && !it->second.pending)
+                s.entries.erase(it);
+        }
+
+        // Drops expired entries; live ones and computations in flight are kept.
+        void purge() {
+            const auto now = Clock::now();
+            for (auto &s : m_shards) {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                for (auto it = s.entries.begin(); it != s.entries.end();) {
+                    if (!it->second.pending && !(now < it->second.expires))
+                        it = s.entries.erase(it);
+                    else
+                        ++it;
+                }
+            }
+        }
+
+        std::size_t size() const {
+            std::size_t n = 0;
+            for (auto &s : m_shards) {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                n += s.entries.size();
+            }
+            return n;
+        }
+
+    private:
+        struct flight {
+            std::mutex mutex;
+            std::condition_variable done;
+            bool finished = false;
+            handle outcome;
+        };
+
+        struct entry {
+            handle cached;
+            typename Clock::time_point expires;
+            std::shared_ptr<flight> pending;
+        };
+
+        struct shard {
+            mutable std::mutex mutex;
+            std::unordered_map<Key, entry, Hash> entries;
+            char pad[_m::cache_line];
+        };
+
+        // Publishes the outcome to waiters even when func throws; a null outcome sends them back to retry.
+        class landing {
+        public:
+            landing(memoize &owner, shard &s, const Key &key, std::shared_ptr<flight> f):
+                    m_owner(owner), m_shard(s), m_key(key), m_flight(std::move(f))
+            {}
+
+            ~landing() {
+                {
+                    std::lock_guard<std::mutex> lock(m_shard.mutex);
+                    const auto it = m_shard.entries.find(m_key);
+                    if (it != m_shard.entries.end() && it->second.pending == m_flight) {
+                        const auto ttl = outcome ? m_owner.ttl_of(*outcome) : duration::zero();
+                        if (ttl > duration::zero()) {
+                            it->second.pending.reset();
+                            it->second.cached = outcome;
+                            it->second.expires = Clock::now() + ttl;
+                        } else {
+                            m_shard.entries.erase(it);
+                        }
+                    }
+                }
+                {
+                    std::lock_guard<std::mutex> lock(m_flight->mutex);
+                    m_flight->outcome = outcome;
+                    m_flight->finished = true;
+                }
+                m_flight->done.notify_all();
+            }
+
+            handle outcome;
+
+        private:
+            memoize &m_owner;
+            shard &m_shard;
+            const Key &m_key;
+            std::shared_ptr<flight> m_flight;
+        };
+
+        template<typename Func>
+        handle compute(shard &s, const Key &key, const std::shared_ptr<flight> &pending, Func &func) {
+            landing l{*this, s, key, pending};
+            l.outcome = std::make_shared<const result_type>(_m::evaluate<result_type>(func, key));
+            return l.outcome;
+        }
+
+        duration ttl_of(const result_type &r) const noexcept { return r.is_ok() ? m_value_ttl : m_error_ttl; }
+
+        shard& shard_of(const Key &key) { return m_shards[m_hash(key) % m_shards.size()]; }
+        const shard& shard_of(const Key &key) const { return m_shards[m_hash(key) % m_shards.size()]; }
+
+        const duration m_value_ttl;
+        const duration m_error_ttl;
+        Hash m_hash;
+        std::vector<shard> m_shards;
+    };
+}
@@ -1,7 +1,54 @@
 #pragma once
 
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <new>
 #include <stdexcept>
+#include <string>
 #include <type_traits>
+#include <utility>
+
+#if !defined(OPEX_NO_EXCEPTIONS) && !defined(__cpp_exceptions) && !defined(__EXCEPTIONS) && !defined(_CPPUNWIND)
+#define OPEX_NO_EXCEPTIONS
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define OPEX_LIKELY(x) __builtin_expect(!!(x), 1)
+#define OPEX_UNLIKELY(x) __builtin_expect(!!(x), 0)
+#define OPEX_COLD __attribute__((cold, noinline))
+#elif defined(_MSC_VER)
+#define OPEX_LIKELY(x) (x)
+#define OPEX_UNLIKELY(x) (x)
+#define OPEX_COLD __declspec(noinline)
+#else
+#define OPEX_LIKELY(x) (x)
+#define OPEX_UNLIKELY(x) (x)
+#define OPEX_COLD
+#endif
+
+#if __cplusplus >= 201402L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201402L)
+#define OPEX_DEPRECATED(message) [[deprecated(message)]]
+#elif defined(__GNUC__) || defined(__clang__)
+#define OPEX_DEPRECATED(message) __attribute__((deprecated(message)))
+#else
+#define OPEX_DEPRECATED(message)
+#endif
+
+// OPEX_FAULT_INJECTION changes what calls through a fault site compile to, so sites live in an inline namespace
+// named after the setting. Everything taking a site then has a distinct symbol per setting: translation units
+// built with and without injection never share a definition, and handing a site from one to the other fails
+// to link instead of silently running whichever body the linker kept.
+#ifdef OPEX_FAULT_INJECTION
+#define OPEX_FAULT_ABI injected
+#else
+#define OPEX_FAULT_ABI inert
+#endif
 
 namespace opex {
     namespace _t {
@@ -9,90 +56,795 @@ namespace opex {
         template<typename... Ts> using void_t = typename make_void<Ts...>::type;
 
         template<bool B, typename T = void> using enable_if_t = typename std::enable_if<B, T>::type;
-        template<typename T> using result_of_t = typename std::result_of<T>::type;
+        template<typename F, typename... Args> using call_result_t = decltype(std::declval<F>()(std::declval<Args>()...));
+
+        struct in_place_t {};
+        struct invoke_t {};
+    }
+
+    namespace _ctx {
+        struct chunk {
+            static constexpr std::size_t capacity = 4096 - sizeof(std::max_align_t);
+
+            std::atomic<std::size_t> refs;
+            std::size_t used;
+
+            unsigned char* data() noexcept {
+                return reinterpret_cast<unsigned char*>(this) + sizeof(std::max_align_t);
+            }
+
+            static chunk* create(std::size_t size) {
+                static_assert(sizeof(chunk) <= sizeof(std::max_align_t), "chunk header must fit in one max_align_t");
+                auto c = static_cast<chunk*>(::operator new(sizeof(std::max_align_t) + size));
+                c->refs.store(1, std::memory_order_relaxed);
+                c->used = 0;
+                return c;
+            }
+
+            static void release(chunk *c) noexcept {
+                if (c->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    ::operator delete(c);
+            }
+        };
+
+        class arena {
+        public:
+            arena() noexcept: m_current(nullptr) {}
+            arena(const arena &) = delete;
+            arena& operator=(const arena &) = delete;
+
+            ~arena() {
+                if (m_current)
+                    chunk::release(m_current);
+            }
+
+            void* allocate(std::size_t size, chunk *&owner) {
+                size = (size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t) * sizeof(std::max_align_t);
+
+                if (size > chunk::capacity) {
+                    owner = chunk::create(size);
+                    return owner->data();
+                }
+
+                if (!m_current || m_current->used + size > chunk::capacity) {
+                    auto fresh = chunk::create(chunk::capacity);
+                    if (m_current)
+                        chunk::release(m_current);
+                    m_current = fresh;
+                }
+
+                m_current->refs.fetch_add(1, std::memory_order_relaxed);
+                owner = m_current;
+                auto p = m_current->data() + m_current->used;
+                m_current->used += size;
+                return p;
+            }
+
+            static arena& local() {
+                static thread_local arena s_arena;
+                return s_arena;
+            }
+
+        private:
+            chunk *m_current;
+        };
+
+        struct frame;
+
+        struct frame_vtable {
+            void (*render)(const frame &, std::string &);
+            void (*destroy)(frame &);
+        };
+
+        struct alignas(std::max_align_t) frame {
+            mutable std::atomic<std::size_t> refs;
+            const frame *next;
+            chunk *owner;
+            const frame_vtable *vtable;
+
+            void* payload() noexcept { return this + 1; }
+            const void* payload() const noexcept { return this + 1; }
+
+            static void release(const frame *f) noexcept {
+                while (f && f->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    const auto next = f->next;
+                    const auto owner = f->owner;
+                    f->vtable->destroy(const_cast<frame&>(*f));
+                    chunk::release(owner);
+                    f = next;
+                }
+            }
+        };
+
+        // C strings are copied into the frame behind the payload, so a frame never points into the caller's storage.
+        struct text {
+            const char *data;
+        };
+
+        // Appends one context argument to the message. Strings, characters, numbers and pointers are handled here;
+        // any other type is written with operator<< by the definition in <opex/context.h>.
+        template<typename T, typename = void>
+        struct renderer;
+
+        template<>
+        struct renderer<text> {
+            static void append(std::string &out, const text &t) { out += t.data; }
+        };
+
+        template<>
+        struct renderer<std::string> {
+            static void append(std::string &out, const std::string &s) { out += s; }
+        };
+
+        template<typename T>
+        struct renderer<T, _t::enable_if_t<std::is_same<T, char>::value || std::is_same<T, signed char>::value ||
+                                           std::is_same<T, unsigned char>::value>> {
+            static void append(std::string &out, T c) { out += static_cast<char>(c); }
+        };
+
+        template<typename T>
+        struct renderer<T, _t::enable_if_t<std::is_integral<T>::value && sizeof(T) != 1>> {
+            static void append(std::string &out, T value) { out += std::to_string(value); }
+        };
+
+        template<>
+        struct renderer<bool> {
+            static void append(std::string &out, bool value) { out += value ? '1' : '0'; }
+        };
+
+        template<typename T>
+        struct renderer<T, _t::enable_if_t<std::is_floating_point<T>::value>> {
+            static void append(std::string &out, T value) {
+                char buffer[32];
+                const auto n = std::snprintf(buffer, sizeof(buffer), "%Lg", static_cast<long double>(value));
+                out.append(buffer, n > 0 ? static_cast<std::size_t>(n) : 0);
+            }
+        };
+
+        template<typename T>
+        struct renderer<T*> {
+            static void append(std::string &out, const T *p) {
+                char buffer[32];
+                const auto n = std::snprintf(buffer, sizeof(buffer), "%p", static_cast<const void*>(p));
+                out.append(buffer, n > 0 ? static_cast<std::size_t>(n) : 0);
+            }
+        };
+
+        template<typename... Ts> struct payload;
+
+        template<> struct payload<> {
+            void render(std::string &) const {}
+        };
+
+        template<typename T, typename... Ts>
+        struct payload<T, Ts...> {
+            template<typename U, typename... Us>
+            explicit payload(U &&u, Us &&... us):
+                    head(std::forward<U>(u)),
+                    tail(std::forward<Us>(us)...)
+            {}
+
+            void render(std::string &out) const {
+                renderer<T>::append(out, head);
+                tail.render(out);
+            }
+
+            T head;
+            payload<Ts...> tail;
+        };
+
+        template<typename T, typename D = typename std::decay<T>::type>
+        struct is_c_string : std::integral_constant<bool, std::is_same<D, char*>::value ||
+                                                          std::is_same<D, const char*>::value> {};
+
+        template<typename T>
+        using stored_t = typename std::conditional<is_c_string<T>::value, text, typename std::decay<T>::type>::type;
+
+        inline std::size_t text_size(const char *s) noexcept {
+            return s ? std::strlen(s) + 1 : 1;
+        }
+
+        template<typename T>
+        std::size_t extra_size(const T &arg, std::true_type) noexcept { return text_size(arg); }
+
+        template<typename T>
+        std::size_t extra_size(const T &, std::false_type) noexcept { return 0; }
+
+        inline text stash(const char *s, char *&cursor, std::true_type) noexcept {
+            const auto size = text_size(s);
+            if (s)
+                std::memcpy(cursor, s, size);
+            else
+                *cursor = '\0';
+            const text t{cursor};
+            cursor += size;
+            return t;
+        }
+
+        template<typename T>
+        T&& stash(T &&arg, char *&, std::false_type) noexcept {
+            return std::forward<T>(arg);
+        }
+
+        template<typename Payload>
+        struct frame_of {
+            static void render(const frame &f, std::string &out) {
+                static_cast<const Payload*>(f.payload())->render(out);
+            }
+
+            static void destroy(frame &f) {
+                static_cast<Payload*>(f.payload())->~Payload();
+                f.~frame();
+            }
+
+            static const frame_vtable vtable;
+        };
+
+        template<typename Payload>
+        const frame_vtable frame_of<Payload>::vtable = {&frame_of<Payload>::render, &frame_of<Payload>::destroy};
+
+        class chain {
+        public:
+            chain() noexcept: m_head(nullptr) {}
+
+            chain(const chain &other) noexcept: m_head(other.m_head) {
+                if (m_head)
+                    m_head->refs.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            chain(chain &&other) noexcept: m_head(other.m_head) {
+                other.m_head = nullptr;
+            }
+
+            chain& operator=(chain other) noexcept {
+                std::swap(m_head, other.m_head);
+                return *this;
+            }
+
+            ~chain() { frame::release(m_head); }
+
+            explicit operator bool() const noexcept { return m_head != nullptr; }
+
+            template<typename... Args>
+            void push(Args &&... args) {
+                using payload_type = payload<stored_t<Args>...>;
+                static_assert(alignof(payload_type) <= alignof(frame), "over-aligned context arguments are not supported");
+
+                std::size_t extra = 0;
+                const std::size_t sizes[] = {0, extra_size(args, is_c_string<Args>{})...};
+                for (auto size : sizes)
+                    extra += size;
+
+                chunk *owner;
+                auto f = static_cast<frame*>(arena::local().allocate(sizeof(frame) + sizeof(payload_type) + extra, owner));
+                auto cursor = static_cast<char*>(f->payload()) + sizeof(payload_type);
+#ifdef OPEX_NO_EXCEPTIONS
+                new(f->payload()) payload_type{stash(std::forward<Args>(args), cursor, is_c_string<Args>{})...};
+#else
+                try {
+                    new(f->payload()) payload_type{stash(std::forward<Args>(args), cursor, is_c_string<Args>{})...};
+                } catch (...) {
+                    chunk::release(owner);
+                    throw;
+                }
+#endif
+
+                new(f) frame;
+                f->refs.store(1, std::memory_order_relaxed);
+                f->next = m_head;
+                f->owner = owner;
+                f->vtable = &frame_of<payload_type>::vtable;
+                m_head = f;
+            }
+
+            std::string render(const char *message) const {
+                std::string out;
+                for (auto f = m_head; f; f = f->next) {
+                    f->vtable->render(*f, out);
+                    out += ": ";
+                }
+                return out += message;
+            }
+
+            std::string dump(const char *message) const {
+                struct frames {
+                    ~frames() { delete[] data; }
+                    const frame **data;
+                };
+
+                std::size_t n = 0;
+                for (auto f = m_head; f; f = f->next)
+                    ++n;
+
+                const frames newest_first{new const frame*[n]};
+                n = 0;
+                for (auto f = m_head; f; f = f->next)
+                    newest_first.data[n++] = f;
+
+                std::string out{message};
+                while (n--) {
+                    out += "\n  ";
+                    newest_first.data[n]->vtable->render(*newest_first.data[n], out);
+                }
+                return out;
+            }
+
+        private:
+            const frame *m_head;
+        };
+    }
+
+    namespace _t {
+        class cached_string {
+        public:
+            cached_string() noexcept: m_value(nullptr) {}
+            cached_string(const cached_string &) noexcept: m_value(nullptr) {}
+            cached_string& operator=(const cached_string &) noexcept { reset(); return *this; }
+            ~cached_string() { reset(); }
+
+            void reset() noexcept { delete m_value.exchange(nullptr); }
+
+            template<typename Render>
+            const char* get(Render &&render, const char *fallback) const noexcept {
+                if (const auto value = m_value.load(std::memory_order_acquire))
+                    return value->c_str();
+
+#ifdef OPEX_NO_EXCEPTIONS
+                (void) fallback;
+                return publish(new std::string(render()));
+#else
+                try {
+                    return publish(new std::string(render()));
+                } catch (...) {
+                    return fallback;
+                }
+#endif
+            }
+
+        private:
+            const char* publish(const std::string *fresh) const noexcept {
+                const std::string *expected = nullptr;
+                if (!m_value.compare_exchange_strong(expected, fresh, std::memory_order_acq_rel)) {
+                    delete fresh;
+                    return expected->c_str();
+                }
+                return fresh->c_str();
+            }
+
+            mutable std::atomic<const std::string*> m_value;
+        };
+
+        struct access;
     }
 
+    // Called instead of throwing when exceptions are disabled; it receives a description of the error and
+    // must not return (opex aborts if it does). The default handler prints the description to stderr.
+    using terminate_handler = void (*)(const char *message);
+
+    namespace _e {
+        inline std::atomic<terminate_handler>& handler() noexcept {
+            static std::atomic<terminate_handler> s_handler{nullptr};
+            return s_handler;
+        }
+
+        [[noreturn]] OPEX_COLD inline void fail(const char *message) noexcept {
+            if (const auto h = handler().load(std::memory_order_acquire))
+                h(message);
+            else
+                std::fprintf(stderr, "opex: %s\n", message);
+            std::abort();
+        }
+
+        template<typename ExceptionType>
+        [[noreturn]] OPEX_COLD void raise(const char *message) {
+#ifdef OPEX_NO_EXCEPTIONS
+            fail(message);
+#else
+            throw ExceptionType(message);
+#endif
+        }
+
+#ifdef OPEX_NO_EXCEPTIONS
+        struct object;
+
+        struct object_vtable {
+            const char* (*what)(const object &);
+            void (*destroy)(object *);
+        };
+
+        struct object {
+            std::atomic<std::size_t> refs;
+            const object_vtable *vtable;
+        };
+
+        template<typename T, bool = std::is_base_of<std::exception, T>::value>
+        struct what_of {
+            static const char* get(const T &e) noexcept { return e.what(); }
+        };
+
+        template<typename T>
+        struct what_of<T, false> {
+            static const char* get(const T &) noexcept { return ""; }
+        };
+
+        template<typename T>
+        struct object_of : object {
+            template<typename U>
+            explicit object_of(U &&u): value(std::forward<U>(u)) {}
+
+            static const char* what(const object &o) {
+                return what_of<T>::get(static_cast<const object_of&>(o).value);
+            }
+
+            static void destroy(object *o) {
+                delete static_cast<object_of*>(o);
+            }
+
+            static const object_vtable s_vtable;
+
+            T value;
+        };
+
+        template<typename T>
+        const object_vtable object_of<T>::s_vtable = {&object_of<T>::what, &object_of<T>::destroy};
+
+        // Value based stand-in for std::exception_ptr: a refcounted copy of the error object together with a
+        // pointer to the subobject of the exception type the owning result was declared with.
+        class error_ptr {
+        public:
+            error_ptr() noexcept: m_object(nullptr), m_value(nullptr) {}
+
+            error_ptr(const error_ptr &other) noexcept: m_object(other.m_object), m_value(other.m_value) {
+                if (m_object)
+                    m_object->refs.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            error_ptr(error_ptr &&other) noexcept: m_object(other.m_object), m_value(other.m_value) {
+                other.m_object = nullptr;
+                other.m_value = nullptr;
+            }
+
+            error_ptr& operator=(error_ptr other) noexcept {
+                std::swap(m_object, other.m_object);
+                std::swap(m_value, other.m_value);
+                return *this;
+            }
+
+            ~error_ptr() {
+                if (m_object && m_object->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    m_object->vtable->destroy(m_object);
+            }
+
+            template<typename Base, typename T>
+            static error_ptr make(T &&value) {
+                using stored_type = typename std::decay<T>::type;
+                auto o = new object_of<stored_type>(std::forward<T>(value));
+                o->refs.store(1, std::memory_order_relaxed);
+                o->vtable = &object_of<stored_type>::s_vtable;
+
+                error_ptr e;
+                e.m_object = o;
+                e.m_value = static_cast<Base*>(&o->value);
+                return e;
+            }
+
+            explicit operator bool() const noexcept { return m_object != nullptr; }
+
+            void* get() const noexcept { return m_value; }
+            const char* what() const noexcept { return m_object ? m_object->vtable->what(*m_object) : ""; }
+
+            template<typename From, typename To>
+            void upcast() noexcept {
+                m_value = static_cast<To*>(static_cast<From*>(m_value));
+            }
+
+        private:
+            object *m_object;
+            void *m_value;
+        };
+
+        template<typename Base, typename T>
+        error_ptr make_error_ptr(T &&value) {
+            return error_ptr::make<Base>(std::forward<T>(value));
+        }
+#else
+        using error_ptr = std::exception_ptr;
+
+        template<typename Base, typename T>
+        error_ptr make_error_ptr(T &&value) {
+            return std::make_exception_ptr(std::forward<T>(value));
+        }
+#endif
+    }
+
+    inline terminate_handler set_terminate_handler(terminate_handler handler) noexcept {
+        return _e::handler().exchange(handler, std::memory_order_acq_rel);
+    }
+
+    inline terminate_handler get_terminate_handler() noexcept {
+        return _e::handler().load(std::memory_order_acquire);
+    }
+
+    // Tagged call sites for fault injection; see <opex/fault.h>.
+    namespace fault {
+        inline namespace OPEX_FAULT_ABI {
+            template<typename ExceptionType>
+            class site;
+        }
+    }
+
+    // A single pointer, so the default handle adds nothing to a result beyond the exception_ptr it replaced.
+    // The exception and its context frames live in a refcounted box; copies share it until one of them
+    // attaches context or is upcast, which gives that copy a box of its own.
+    class shared_error_handle {
+        struct box {
+            explicit box(_e::error_ptr &&e) noexcept: refs(1), exception(std::move(e)) {}
+            box(const box &other) noexcept: refs(1), exception(other.exception), context(other.context) {}
+
+            std::atomic<std::size_t> refs;
+            _e::error_ptr exception;
+            _ctx::chain context;
+        };
+
+    public:
+        explicit shared_error_handle(_e::error_ptr &&exception):
+                m_box(new box(std::move(exception)))
+        {}
+
+        explicit shared_error_handle(const _e::error_ptr &exception):
+                shared_error_handle(_e::error_ptr{exception})
+        {}
+
+        shared_error_handle(const shared_error_handle &other) noexcept: m_box(other.m_box) {
+            m_box->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        shared_error_handle(shared_error_handle &&other) noexcept: m_box(other.m_box) {
+            other.m_box = nullptr;
+        }
+
+        shared_error_handle& operator=(shared_error_handle other) noexcept {
+            std::swap(m_box, other.m_box);
+            return *this;
+        }
+
+        ~shared_error_handle() {
+            if (m_box && m_box->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                delete m_box;
+        }
+
+        const _e::error_ptr& exception() const noexcept { return m_box->exception; }
+        const _ctx::chain& context() const noexcept { return m_box->context; }
+
+        _ctx::chain& mutable_context() {
+            unshare();
+            return m_box->context;
+        }
+
+        template<typename From, typename To>
+        void upcast() {
+#ifdef OPEX_NO_EXCEPTIONS
+            if (!std::is_same<From, To>::value) {
+                unshare();
+                m_box->exception.template upcast<From, To>();
+            }
+#endif
+        }
+
+    private:
+        void unshare() {
+            if (m_box->refs.load(std::memory_order_acquire) != 1) {
+                const auto fresh = new box(*m_box);
+                if (m_box->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    delete m_box;
+                m_box = fresh;
+            }
+        }
+
+        box *m_box;
+    };
+
+    static_assert(sizeof(shared_error_handle) == sizeof(void*), "the default error handle must stay one pointer wide");
+
+    class confined_error_handle {
+        struct box {
+            std::size_t refs;
+            _e::error_ptr exception;
+            _ctx::chain context;
+#ifndef NDEBUG
+            const void *owner;
+#endif
+        };
+
+    public:
+        explicit confined_error_handle(_e::error_ptr &&exception):
+                m_box(new box{1, std::move(exception), {}
+#ifndef NDEBUG
+                              , thread_tag()
+#endif
+                })
+        {}
+
+        explicit confined_error_handle(const _e::error_ptr &exception):
+                confined_error_handle(_e::error_ptr{exception})
+        {}
+
+        confined_error_handle(const confined_error_handle &other) noexcept: m_box(other.m_box) {
+            check_owner();
+            ++m_box->refs;
+        }
+
+        confined_error_handle(confined_error_handle &&other) noexcept: m_box(other.m_box) {
+            other.m_box = nullptr;
+        }
+
+        confined_error_handle& operator=(confined_error_handle other) noexcept {
+            std::swap(m_box, other.m_box);
+            return *this;
+        }
+
+        ~confined_error_handle() {
+            if (m_box) {
+                check_owner();
+                if (--m_box->refs == 0)
+                    delete m_box;
+            }
+        }
+
+        const _e::error_ptr& exception() const noexcept { check_owner(); return m_box->exception; }
+        const _ctx::chain& context() const noexcept { check_owner(); return m_box->context; }
+
+        _ctx::chain& mutable_context() {
+            unshare();
+            return m_box->context;
+        }
+
+        template<typename From, typename To>
+        void upcast() {
+#ifdef OPEX_NO_EXCEPTIONS
+            if (!std::is_same<From, To>::value) {
+                unshare();
+                m_box->exception.template upcast<From, To>();
+            }
+#endif
+        }
+
+    private:
+        void unshare() {
+            check_owner();
+            if (m_box->refs > 1) {
+                --m_box->refs;
+                m_box = new box(*m_box);
+                m_box->refs = 1;
+            }
+        }
+
+        // The address of a thread_local stands in for std::thread::id, which would drag <thread> into every user.
+        static const void* thread_tag() noexcept {
+            static thread_local char s_tag;
+            return &s_tag;
+        }
+
+        void check_owner() const noexcept {
+            assert(m_box->owner == thread_tag() && "opex: confined error used outside its owning thread");
+        }
+
+        box *m_box;
+    };
+
     template<typename>
     struct is_result : public std::false_type {};
 
-    template<typename ValueType, typename ExceptionType = std::exception>
+    template<typename ValueType, typename ExceptionType = std::exception, typename ErrorHandle = shared_error_handle>
     class result {
     public:
         using value_type = ValueType;
         using exception_type = ExceptionType;
+        using error_handle = ErrorHandle;
 
-        template <typename E, bool = std::is_base_of<ExceptionType, E>::value>
-        struct is_allowed_exception : std::false_type {};
+        template <typename E>
+        using is_allowed_exception = std::is_base_of<ExceptionType, E>;
 
         template <typename E>
-        struct is_allowed_exception<E, true> : std::true_type {};
+        struct exception_of { using type = E; };
+
+        template <typename V, typename E, typename H>
+        struct exception_of<result<V, E, H>> { using type = E; };
+
+        template <typename>
+        struct compatible {};
+
+        template <typename V, typename E, typename H>
+        struct compatible<result<V, E, H>>
+                : std::enable_if<std::is_base_of<E, ExceptionType>::value && std::is_same<H, ErrorHandle>::value,
+                                 result<V, E, H>> {};
 
-        template <typename, typename = _t::void_t<>>
+        template<typename F, typename Arg>
+        using rebind_value_t = result<_t::call_result_t<F, Arg>, ExceptionType, ErrorHandle>;
+
+        template<typename F, typename Arg>
+        using rebind_error_t = result<ValueType, typename exception_of<_t::call_result_t<F, Arg>>::type, ErrorHandle>;
+
+        template<typename F, typename Arg>
+        using compatible_result_t = typename compatible<_t::call_result_t<F, Arg>>::type;
+
+        // Signature-style spellings from before the traits above; same results, one more instantiation each.
+        template<typename, typename = void>
         struct rebind {};
 
-        template <typename F, typename V>
-        struct rebind<F(V), _t::void_t<_t::result_of_t<F(V)>>> {
-            using type = result<_t::result_of_t<F(V)>, ExceptionType>;
-        };
+        template<typename F, typename V>
+        struct rebind<F(V), _t::void_t<rebind_value_t<F, V>>> { using type = rebind_value_t<F, V>; };
 
-        template <typename, typename = _t::void_t<>>
+        template<typename, typename = void>
         struct rebind_err {};
 
-        template <typename F, typename E>
-        struct rebind_err<F(E), _t::void_t<_t::enable_if_t<!is_result<_t::result_of_t<F(E)>>::value>>> {
-            using type = result<ValueType, _t::result_of_t<F(E)>>;
-        };
+        template<typename F, typename E>
+        struct rebind_err<F(E), _t::void_t<rebind_error_t<F, E>>> { using type = rebind_error_t<F, E>; };
 
-        template <typename F, typename E>
-        struct rebind_err<F(E), _t::void_t<_t::enable_if_t<is_result<_t::result_of_t<F(E)>>::value>>> {
-            using type = result<ValueType, typename _t::result_of_t<F(E)>::exception_type>;
-        };
-
-        template <typename, typename = _t::void_t<>>
+        template<typename, typename = void>
         struct compatible_result_of {};
 
-        template <typename F, typename Arg>
-        struct compatible_result_of<F(Arg), _t::void_t<_t::enable_if_t<
-                is_result<_t::result_of_t<F(Arg)>>::value &&
-                std::is_base_of<typename _t::result_of_t<F(Arg)>::exception_type, ExceptionType>::value>>> {
-            using type = _t::enable_if_t<
-                    is_result<_t::result_of_t<F(Arg)>>::value &&
-                    std::is_base_of<typename _t::result_of_t<F(Arg)>::exception_type, ExceptionType>::value,
-                    typename _t::result_of_t<F(Arg)>
-            >;
+        template<typename F, typename Arg>
+        struct compatible_result_of<F(Arg), _t::void_t<compatible_result_t<F, Arg>>> {
+            using type = compatible_result_t<F, Arg>;
         };
 
-        template<typename T> using rebind_t = typename rebind<T>::type;
-        template<typename T> using rebind_err_t = typename rebind_err<T>::type;
-        template<typename T> using compatible_result_of_t = typename compatible_result_of<T>::type;
+        template<typename T>
+        using rebind_t OPEX_DEPRECATED("use rebind_value_t<F, Arg>") = typename rebind<T>::type;
 
+        template<typename T>
+        using rebind_err_t OPEX_DEPRECATED("use rebind_error_t<F, Arg>") = typename rebind_err<T>::type;
 
-        ~result() {
-            using exception_ptr = std::exception_ptr;
+        template<typename T>
+        using compatible_result_of_t OPEX_DEPRECATED("use compatible_result_t<F, Arg>") = typename compatible_result_of<T>::type;
 
-            switch (m_type) {
-                case Type::Value:
-                    m_value.~ValueType();
-                    break;
-                case Type::Exception:
-                    m_exception.~exception_ptr();
-                    break;
-            }
+
+        ~result() {
+            if (OPEX_LIKELY(is_ok()))
+                m_value.~ValueType();
+            else
+                destroy_error();
         }
 
-        result(result &&other) {
-            switch (m_type = other.m_type) {
-                case Type::Value:
-                    new(&m_value) ValueType{std::move(other.m_value)};
-                    break;
-                case Type::Exception:
-                    new(&m_exception) std::exception_ptr{std::move(other.m_exception)};
-                    break;
-            }
+        result(result &&other):
+                m_type(other.m_type)
+        {
+            if (OPEX_LIKELY(is_ok()))
+                new(&m_value) ValueType(std::move(other.m_value));
+            else
+                new(&m_error) ErrorHandle(std::move(other.m_error));
         }
 
         result(const result &) = delete;
 
+        // Widening the error keeps the stored exception; only the handle moves over, nothing is rethrown.
+        template<typename V, typename E,
+                 _t::enable_if_t<!std::is_same<result<V, E, ErrorHandle>, result>::value &&
+                                 std::is_base_of<ExceptionType, E>::value &&
+                                 std::is_convertible<V&&, ValueType>::value>* = nullptr>
+        result(result<V, E, ErrorHandle> &&other):
+                m_type(other.is_ok() ? Type::Value : Type::Exception)
+        {
+            if (OPEX_LIKELY(is_ok()))
+                new(&m_value) ValueType(std::move(other.m_value));
+            else
+                adopt_error<E>(std::move(other.m_error));
+        }
+
+        // Copies stay explicit, as for same-typed results; the error handle is shared rather than copied.
+        template<typename V, typename E,
+                 _t::enable_if_t<!std::is_same<result<V, E, ErrorHandle>, result>::value &&
+                                 std::is_base_of<ExceptionType, E>::value &&
+                                 std::is_convertible<const V&, ValueType>::value>* = nullptr>
+        explicit result(const result<V, E, ErrorHandle> &other):
+                m_type(other.is_ok() ? Type::Value : Type::Exception)
+        {
+            if (OPEX_LIKELY(is_ok()))
+                new(&m_value) ValueType(other.m_value);
+            else
+                adopt_error<E>(other.m_error);
+        }
+
         explicit result(const ValueType &value):
                 m_value(value),
                 m_type(Type::Value)
@@ -106,7 +858,7 @@ namespace opex {
         template<typename NewExceptionType,
                  typename _t::enable_if_t<is_allowed_exception<NewExceptionType>::value>* = nullptr>
         static result from_exception(NewExceptionType &&exception) {
-            return result{std::make_exception_ptr(std::forward<NewExceptionType>(exception))};
+            return result{_e::make_error_ptr<ExceptionType>(std::forward<NewExceptionType>(exception))};
         };
 
         template<typename NewExceptionType,
@@ -118,46 +870,62 @@ namespace opex {
 
         template<typename Func>
         static result call(Func &&func) {
+#ifdef OPEX_NO_EXCEPTIONS
+            return result{_t::invoke_t{}, func};
+#else
             try {
-                return result{func()};
+                return result{_t::invoke_t{}, func};
             } catch (const ExceptionType &) {
                 return result{std::current_exception()};
             }
+#endif
+        }
+
+        template<typename FaultType, typename Func>
+        static result call(const fault::site<FaultType> &site, Func &&func) {
+            static_assert(is_allowed_exception<FaultType>::value, "fault site injects an exception this result cannot hold");
+#ifdef OPEX_FAULT_INJECTION
+            if (OPEX_UNLIKELY(site.fire()))
+                return result{site.template make_error<ExceptionType>()};
+#else
+            (void)site;
+#endif
+            return call(std::forward<Func>(func));
         }
 
         template<typename Func,
-                 typename ResultType = rebind_t<Func(const ValueType &)>>
+                 typename ResultType = rebind_value_t<Func, const ValueType &>>
         ResultType map(Func &&func) const& {
-            return is_ok() ? ResultType{func(m_value)}
-                           : ResultType{m_exception};
+            return OPEX_LIKELY(is_ok()) ? ResultType{_t::invoke_t{}, func, m_value}
+                                        : error_as<ResultType>();
         };
 
         template<typename Func,
-                 typename ResultType = rebind_t<Func(ValueType &&)>>
+                 typename ResultType = rebind_value_t<Func, ValueType &&>>
         ResultType map(Func &&func) && {
-            return is_ok() ? ResultType{func(std::move(m_value))}
-                           : ResultType{std::move(m_exception)};
+            return OPEX_LIKELY(is_ok()) ? ResultType{_t::invoke_t{}, func, std::move(m_value)}
+                                        : std::move(*this).template error_as<ResultType>();
         };
 
         template<typename Func,
-                 typename ResultType = rebind_err_t<Func(const ExceptionType &)>>
+                 typename ResultType = rebind_error_t<Func, const ExceptionType &>>
         ResultType map_err(Func &&func) const& {
-            return is_ok() ? ResultType(m_value)
-                           : ResultType::from_exception(err_visit(std::forward<Func>(func)));
+            return OPEX_LIKELY(is_ok()) ? ResultType(m_value)
+                                        : map_error<ResultType>(std::forward<Func>(func));
         };
 
         template<typename Func,
-                 typename ResultType = rebind_err_t<Func(ExceptionType &)>>
+                 typename ResultType = rebind_error_t<Func, ExceptionType &>>
         ResultType map_err(Func &&func) & {
-            return is_ok() ? ResultType(m_value)
-                           : ResultType::from_exception(err_visit(std::forward<Func>(func)));
+            return OPEX_LIKELY(is_ok()) ? ResultType(m_value)
+                                        : map_error<ResultType>(std::forward<Func>(func));
         };
 
         template<typename Func,
-                 typename ResultType = rebind_err_t<Func(ExceptionType &&)>>
+                 typename ResultType = rebind_error_t<Func, ExceptionType &&>>
         ResultType map_err(Func &&func) && {
-            return is_ok() ? ResultType(std::move(m_value))
-                           : ResultType::from_exception(std::move(*this).err_visit(std::forward<Func>(func)));
+            return OPEX_LIKELY(is_ok()) ? ResultType(std::move(m_value))
+                                        : std::move(*this).template map_error<ResultType>(std::forward<Func>(func));
         };
 
         const result& and_select(const result &other ) const& { return is_ok() ? other : *this; }
@@ -169,87 +937,123 @@ namespace opex {
               result  or_select(      result &&other) &&     { return is_err() ? std::move(other) : std::move(*this); }
 
         template<typename Func,
-                 typename ResultType = compatible_result_of_t<Func(const ValueType &)>>
+                 typename = _t::enable_if_t<std::is_same<_t::call_result_t<Func>, result>::value>>
+        result and_select_with(Func &&func) const& { return OPEX_LIKELY(is_ok()) ? func() : error_as<result>(); }
+
+        template<typename Func,
+                 typename = _t::enable_if_t<std::is_same<_t::call_result_t<Func>, result>::value>>
+        result and_select_with(Func &&func) &      { return OPEX_LIKELY(is_ok()) ? func() : error_as<result>(); }
+
+        template<typename Func,
+                 typename = _t::enable_if_t<std::is_same<_t::call_result_t<Func>, result>::value>>
+        result and_select_with(Func &&func) &&     { return is_ok() ? func() : std::move(*this); }
+
+        template<typename Func,
+                 typename = _t::enable_if_t<std::is_same<_t::call_result_t<Func>, result>::value>>
+        result or_select_with(Func &&func) const& { return is_err() ? func() : result{m_value}; }
+
+        template<typename Func,
+                 typename = _t::enable_if_t<std::is_same<_t::call_result_t<Func>, result>::value>>
+        result or_select_with(Func &&func) &      { return is_err() ? func() : result{m_value}; }
+
+        template<typename Func,
+                 typename = _t::enable_if_t<std::is_same<_t::call_result_t<Func>, result>::value>>
+        result or_select_with(Func &&func) &&     { return is_err() ? func() : std::move(*this); }
+
+        template<typename Func,
+                 typename ResultType = compatible_result_t<Func, const ValueType &>>
         ResultType and_then(Func &&func) const& {
-            return is_ok() ? func(m_value)
-                           : ResultType{m_exception};
+            return OPEX_LIKELY(is_ok()) ? func(m_value)
+                                        : error_as<ResultType>();
         };
 
         template<typename Func,
-                 typename ResultType = compatible_result_of_t<Func(ValueType &)>>
+                 typename ResultType = compatible_result_t<Func, ValueType &>>
         ResultType and_then(Func &&func) & {
-            return is_ok() ? func(m_value)
-                           : ResultType{m_exception};
+            return OPEX_LIKELY(is_ok()) ? func(m_value)
+                                        : error_as<ResultType>();
         };
 
         template<typename Func,
-                typename ResultType = compatible_result_of_t<Func(ValueType &&)>>
+                typename ResultType = compatible_result_t<Func, ValueType &&>>
         ResultType and_then(Func &&func) && {
-            return is_ok() ? func(std::move(m_value))
-                           : ResultType{std::move(m_exception)};
+            return OPEX_LIKELY(is_ok()) ? func(std::move(m_value))
+                                        : std::move(*this).template error_as<ResultType>();
         };
 
         template<typename Func,
-                 typename ResultType = rebind_err_t<Func(const ExceptionType &)>>
+                 typename ResultType = rebind_error_t<Func, const ExceptionType &>>
         ResultType or_else(Func &&func) const& {
-            return is_ok() ? ResultType(m_value)
-                           : err_visit(std::forward<Func>(func));
+            return OPEX_LIKELY(is_ok()) ? ResultType(m_value)
+                                        : visit_error<ResultType>(std::forward<Func>(func));
         };
 
         template<typename Func,
-                 typename ResultType = rebind_err_t<Func(ExceptionType &)>>
+                 typename ResultType = rebind_error_t<Func, ExceptionType &>>
         ResultType or_else(Func &&func) & {
-            return is_ok() ? ResultType(m_value)
-                           : err_visit(std::forward<Func>(func));
+            return OPEX_LIKELY(is_ok()) ? ResultType(m_value)
+                                        : visit_error<ResultType>(std::forward<Func>(func));
         };
 
         template<typename Func,
-                 typename ResultType = rebind_err_t<Func(ExceptionType &&)>>
+                 typename ResultType = rebind_error_t<Func, ExceptionType &&>>
         ResultType or_else(Func &&func) && {
-            return is_ok() ? ResultType(std::move(m_value))
-                           : std::move(*this).err_visit(std::forward<Func>(func));
+            return OPEX_LIKELY(is_ok()) ? ResultType(std::move(m_value))
+                                        : std::move(*this).template visit_error<ResultType>(std::forward<Func>(func));
         };
 
         template<typename Func>
-        auto err_visit(Func &&func) const& -> _t::result_of_t<Func(const ExceptionType&)> {
+        auto err_visit(Func &&func) const& -> _t::call_result_t<Func, const ExceptionType&> {
             if (!is_err())
-                throw std::logic_error("err_visit can only be called on error'd instances");
+                _e::raise<std::logic_error>("err_visit can only be called on error'd instances");
 
+#ifdef OPEX_NO_EXCEPTIONS
+            return func(error_object());
+#else
             try {
-                std::rethrow_exception(m_exception);
+                std::rethrow_exception(m_error.exception());
             } catch (const ExceptionType &exc) {
                 return func(exc);
             }
 
             throw std::logic_error("BUG: We failed to catch our exception...");
+#endif
         }
 
         template<typename Func>
-        auto err_visit(Func &&func) & -> _t::result_of_t<Func(ExceptionType&)> {
+        auto err_visit(Func &&func) & -> _t::call_result_t<Func, ExceptionType&> {
             if (!is_err())
-                throw std::logic_error("err_visit can only be called on error'd instances");
+                _e::raise<std::logic_error>("err_visit can only be called on error'd instances");
 
+#ifdef OPEX_NO_EXCEPTIONS
+            return func(error_object());
+#else
             try {
-                std::rethrow_exception(m_exception);
+                std::rethrow_exception(m_error.exception());
             } catch (ExceptionType &exc) {
                 return func(exc);
             }
 
             throw std::logic_error("BUG: We failed to catch our exception...");
+#endif
         }
 
         template<typename Func>
-        auto err_visit(Func &&func) && -> _t::result_of_t<Func(ExceptionType&&)> {
+        auto err_visit(Func &&func) && -> _t::call_result_t<Func, ExceptionType&&> {
             if (!is_err())
-                throw std::logic_error("err_visit can only be called on error'd instances");
+                _e::raise<std::logic_error>("err_visit can only be called on error'd instances");
 
+#ifdef OPEX_NO_EXCEPTIONS
+            return func(std::move(error_object()));
+#else
             try {
-                std::rethrow_exception(m_exception);
+                std::rethrow_exception(m_error.exception());
             } catch (ExceptionType &exc) {
                 return func(std::move(exc));
             }
 
             throw std::logic_error("BUG: We failed to catch our exception...");
+#endif
         }
 
         const ValueType&  unwrap() const& { throw_on_err(); return m_value; }
@@ -269,53 +1073,260 @@ namespace opex {
         bool operator!() const noexcept         { return is_err(); }
 
         std::string what() const noexcept {
+#ifdef OPEX_NO_EXCEPTIONS
+            return is_err() ? describe(m_error.exception().what()) : std::string{};
+#else
             try {
                 throw_on_err();
                 return {};
             }
-            catch (const std::exception &e) { return e.what(); }
-            catch (const std::string &s) { return s; }
-            catch (const char *p) { return p; }
-            catch (...) { return {}; }
+            catch (const std::exception &e) { return describe(e.what()); }
+            catch (const std::string &s) { return describe(s.c_str()); }
+            catch (const char *p) { return describe(p); }
+            catch (...) { return describe(""); }
+#endif
+        }
+
+        std::string diagnostic() const noexcept {
+            if (is_ok())
+                return {};
+
+            const auto message = result{m_error.exception()}.what();
+            return m_error.context() ? m_error.context().dump(message.c_str()) : message;
+        }
+
+        template<typename... Args>
+        result context(Args &&... args) && {
+            if (is_err())
+                m_error.mutable_context().push(std::forward<Args>(args)...);
+            return std::move(*this);
+        }
+
+        template<typename... Args>
+        result context(Args &&... args) const& {
+            if (is_ok())
+                return result{m_value};
+
+            result copy{m_error};
+            copy.m_error.mutable_context().push(std::forward<Args>(args)...);
+            return copy;
         }
 
     private:
-        explicit result(std::exception_ptr &&exception):
-                m_exception(std::move(exception)),
+        template<typename... Args>
+        explicit result(_t::in_place_t, Args &&... args):
+                m_value(std::forward<Args>(args)...),
+                m_type(Type::Value)
+        {}
+
+        // Initialising straight from the call lets the returned value be elided into storage.
+        template<typename Func, typename... Args>
+        explicit result(_t::invoke_t, Func &&func, Args &&... args):
+                m_value(func(std::forward<Args>(args)...)),
+                m_type(Type::Value)
+        {}
+
+        explicit result(_e::error_ptr &&exception):
+                m_error(std::move(exception)),
                 m_type(Type::Exception)
         {}
 
-        explicit result(const std::exception_ptr &exception):
-                m_exception(exception),
+        explicit result(const _e::error_ptr &exception):
+                m_error(exception),
                 m_type(Type::Exception)
         {}
 
+        explicit result(ErrorHandle &&error):
+                m_error(std::move(error)),
+                m_type(Type::Exception)
+        {}
+
+        explicit result(const ErrorHandle &error):
+                m_error(error),
+                m_type(Type::Exception)
+        {}
+
+        result&& with_context(const _ctx::chain &context) && {
+            m_error.mutable_context() = context;
+            return std::move(*this);
+        }
+
+        template<typename FromExceptionType>
+        result&& upcast_error() && {
+            m_error.template upcast<FromExceptionType, ExceptionType>();
+            return std::move(*this);
+        }
+
+        std::string describe(const char *message) const {
+            return m_error.context() ? m_error.context().render(message) : std::string{message};
+        }
+
         void throw_on_err() const {
-            if (is_err())
-                std::rethrow_exception(m_exception);
+            if (OPEX_UNLIKELY(is_err()))
+                rethrow_error();
+        }
+
+        // Error paths are kept out of line so the value paths of the combinators stay small.
+        [[noreturn]] OPEX_COLD void rethrow_error() const {
+#ifdef OPEX_NO_EXCEPTIONS
+            _e::fail(what().c_str());
+#else
+            std::rethrow_exception(m_error.exception());
+#endif
+        }
+
+        OPEX_COLD void destroy_error() noexcept {
+            m_error.~ErrorHandle();
+        }
+
+        template<typename FromExceptionType, typename Handle>
+        OPEX_COLD void adopt_error(Handle &&error) {
+            new(&m_error) ErrorHandle(std::forward<Handle>(error));
+            m_error.template upcast<FromExceptionType, ExceptionType>();
+        }
+
+        template<typename ResultType>
+        OPEX_COLD ResultType error_as() const& {
+            return ResultType{m_error}.template upcast_error<ExceptionType>();
+        }
+
+        template<typename ResultType>
+        OPEX_COLD ResultType error_as() && {
+            return ResultType{std::move(m_error)}.template upcast_error<ExceptionType>();
         }
 
+        template<typename ResultType, typename Func>
+        OPEX_COLD ResultType map_error(Func &&func) const& {
+            return ResultType::from_exception(err_visit(std::forward<Func>(func))).with_context(m_error.context());
+        }
+
+        template<typename ResultType, typename Func>
+        OPEX_COLD ResultType map_error(Func &&func) & {
+            return ResultType::from_exception(err_visit(std::forward<Func>(func))).with_context(m_error.context());
+        }
+
+        template<typename ResultType, typename Func>
+        OPEX_COLD ResultType map_error(Func &&func) && {
+            return ResultType::from_exception(std::move(*this).err_visit(std::forward<Func>(func)))
+                    .with_context(m_error.context());
+        }
+
+        template<typename ResultType, typename Func>
+        OPEX_COLD ResultType visit_error(Func &&func) const& { return err_visit(std::forward<Func>(func)); }
+
+        template<typename ResultType, typename Func>
+        OPEX_COLD ResultType visit_error(Func &&func) &      { return err_visit(std::forward<Func>(func)); }
+
+        template<typename ResultType, typename Func>
+        OPEX_COLD ResultType visit_error(Func &&func) &&     { return std::move(*this).err_visit(std::forward<Func>(func)); }
+
+#ifdef OPEX_NO_EXCEPTIONS
+        ExceptionType& error_object() const noexcept {
+            return *static_cast<ExceptionType*>(m_error.exception().get());
+        }
+#endif
+
     private:
         union {
             ValueType m_value;
-            std::exception_ptr m_exception;
+            ErrorHandle m_error;
         };
         enum class Type {
             Value, Exception
         } m_type;
 
-        template <typename T, typename E>
+        template <typename T, typename E, typename H>
         friend class result;
+
+        friend struct _t::access;
     };
 
+    namespace _t {
+        struct access {
+            template<typename ResultType>
+            static ResultType from_exception_ptr(_e::error_ptr exception) {
+                return ResultType{std::move(exception)};
+            }
+
+            template<typename ResultType>
+            static ResultType copy_error(const ResultType &r) {
+                return ResultType{r.m_error};
+            }
 
-    template<typename T, typename E>
-    struct is_result<result<T, E>> : public std::true_type {};
+            // Bulk kernels read the discriminant as a 32-bit integer that is zero for values.
+            template<typename ResultType>
+            static constexpr bool has_plain_tag() {
+                return sizeof(typename ResultType::Type) == 4 && static_cast<int>(ResultType::Type::Value) == 0;
+            }
+
+            template<typename ResultType>
+            static const _e::error_ptr& exception(const ResultType &r) noexcept { return r.m_error.exception(); }
+
+            template<typename ResultType>
+            static const void* tag_address(const ResultType &r) noexcept { return &r.m_type; }
+
+            template<typename ResultType>
+            static const void* value_address(const ResultType &r) noexcept { return &r.m_value; }
+
+            template<typename ResultType>
+            static auto value(ResultType &&r) noexcept -> decltype((std::forward<ResultType>(r).m_value)) {
+                return std::forward<ResultType>(r).m_value;
+            }
+
+            template<typename ResultType, typename... Args>
+            static ResultType emplace(Args &&... args) {
+                return ResultType{in_place_t{}, std::forward<Args>(args)...};
+            }
+
+            template<typename ResultType, typename Func, typename... Args>
+            static ResultType invoke(Func &&func, Args &&... args) {
+                return ResultType{invoke_t{}, std::forward<Func>(func), std::forward<Args>(args)...};
+            }
+
+            template<typename ResultType, typename Source>
+            static ResultType forward_error(const Source &r) {
+                return ResultType{r.m_error};
+            }
+
+            template<typename ResultType, typename Source, enable_if_t<!std::is_reference<Source>::value>* = nullptr>
+            static ResultType forward_error(Source &&r) {
+                return ResultType{std::move(r.m_error)};
+            }
+
+            template<typename ResultType, typename Source>
+            static ResultType error_as(Source &&r) {
+                return std::forward<Source>(r).template error_as<ResultType>();
+            }
+        };
+    }
+
+
+    template<typename T, typename E, typename H>
+    struct is_result<result<T, E, H>> : public std::true_type {};
+
+    template<typename ValueType, typename ExceptionType = std::exception>
+    using confined_result = result<ValueType, ExceptionType, confined_error_handle>;
 
 
     template<typename ExceptionType = std::exception, typename Func,
-              typename ValueType = _t::result_of_t<Func()>>
+              typename ValueType = _t::call_result_t<Func>>
     result<ValueType, ExceptionType> call(Func &&func) {
         return result<ValueType, ExceptionType>::call(std::forward<Func>(func));
     };
+
+
+    template<typename Func,
+             typename ResultType = _t::call_result_t<Func>>
+    ResultType first_ok(Func &&func) {
+        static_assert(is_result<ResultType>::value, "first_ok alternatives must return an opex::result");
+        return func();
+    }
+
+    template<typename Func, typename... Funcs,
+             typename ResultType = _t::call_result_t<Func>>
+    ResultType first_ok(Func &&func, Funcs &&... funcs) {
+        static_assert(is_result<ResultType>::value, "first_ok alternatives must return an opex::result");
+        auto first = func();
+        return first.is_ok() ? std::move(first) : first_ok(std::forward<Funcs>(funcs)...);
+    }
 }
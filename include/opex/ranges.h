@@ -0,0 +1,209 @@
+#pragma once
+
+#if __cplusplus < 202002L
+#error "opex/ranges.h needs C++20"
+#endif
+
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include <opex/opex.h>
+
+namespace opex {
+    namespace _r {
+        template<typename R>
+        concept result_reference = is_result<std::remove_cvref_t<R>>::value;
+
+        struct is_ok_fn {
+            template<result_reference R>
+            bool operator()(const R &r) const noexcept { return r.is_ok(); }
+        };
+
+        struct is_err_fn {
+            template<result_reference R>
+            bool operator()(const R &r) const noexcept { return r.is_err(); }
+        };
+
+        // Lvalue results, stored or cached, give references to their values; rvalue results give up their value.
+        struct value_fn {
+            template<result_reference R>
+            decltype(auto) operator()(R &&r) const {
+                if constexpr (std::is_lvalue_reference_v<R>)
+                    return (r.unwrap());
+                else
+                    return typename std::remove_cvref_t<R>::value_type(std::move(r).unwrap());
+            }
+        };
+
+        template<typename Func>
+        struct map_ok_fn {
+            template<result_reference R>
+            auto operator()(R &&r) const { return std::forward<R>(r).map(func); }
+
+            Func func;
+        };
+
+        template<typename Func>
+        struct and_then_fn {
+            template<result_reference R>
+            auto operator()(R &&r) const { return std::forward<R>(r).and_then(func); }
+
+            Func func;
+        };
+
+        // Holds the element at the current position, so a filter or take_while over a transform computes each
+        // element once instead of once for the predicate and again for the consumer. Input only; references
+        // into it stay valid until the next increment.
+        template<std::ranges::input_range V>
+            requires std::ranges::view<V>
+        class cache_view : public std::ranges::view_interface<cache_view<V>> {
+            using element_type = std::remove_cvref_t<std::ranges::range_reference_t<V>>;
+
+        public:
+            class iterator {
+            public:
+                using iterator_concept = std::input_iterator_tag;
+                using value_type = element_type;
+                using difference_type = std::ranges::range_difference_t<V>;
+
+                iterator(cache_view &parent, std::ranges::iterator_t<V> current):
+                        m_parent(&parent),
+                        m_current(std::move(current))
+                {}
+
+                iterator(iterator &&) = default;
+                iterator& operator=(iterator &&) = default;
+
+                element_type& operator*() const {
+                    if (!m_parent->m_cache)
+                        m_parent->m_cache.emplace(*m_current);
+                    return *m_parent->m_cache;
+                }
+
+                iterator& operator++() {
+                    ++m_current;
+                    m_parent->m_cache.reset();
+                    return *this;
+                }
+
+                void operator++(int) { ++*this; }
+
+                friend bool operator==(const iterator &it, const std::ranges::sentinel_t<V> &end) {
+                    return it.m_current == end;
+                }
+
+            private:
+                cache_view *m_parent;
+                std::ranges::iterator_t<V> m_current;
+            };
+
+            explicit cache_view(V base): m_base(std::move(base)) {}
+
+            // Copies start with an empty cache; it belongs to whoever is iterating.
+            cache_view(const cache_view &other): m_base(other.m_base) {}
+            cache_view(cache_view &&other): m_base(std::move(other.m_base)) {}
+
+            cache_view& operator=(const cache_view &other) {
+                m_base = other.m_base;
+                m_cache.reset();
+                return *this;
+            }
+
+            cache_view& operator=(cache_view &&other) {
+                m_base = std::move(other.m_base);
+                m_cache.reset();
+                return *this;
+            }
+
+            iterator begin() {
+                m_cache.reset();
+                return iterator{*this, std::ranges::begin(m_base)};
+            }
+
+            auto end() { return std::ranges::end(m_base); }
+
+        private:
+            V m_base;
+            std::optional<element_type> m_cache;
+        };
+
+        // Only ranges that produce results on the fly are cached; references into stored results pass through.
+        template<std::ranges::viewable_range R>
+        auto cached(R &&r) {
+            if constexpr (std::is_reference_v<std::ranges::range_reference_t<R>>)
+                return std::views::all(std::forward<R>(r));
+            else
+                return cache_view{std::views::all(std::forward<R>(r))};
+        }
+
+        struct filter_ok_fn {
+            template<std::ranges::viewable_range R>
+            auto operator()(R &&r) const { return std::views::filter(cached(std::forward<R>(r)), is_ok_fn{}); }
+        };
+
+        struct errors_fn {
+            template<std::ranges::viewable_range R>
+            auto operator()(R &&r) const { return std::views::filter(cached(std::forward<R>(r)), is_err_fn{}); }
+        };
+
+        struct take_while_ok_fn {
+            template<std::ranges::viewable_range R>
+            auto operator()(R &&r) const { return std::views::take_while(cached(std::forward<R>(r)), is_ok_fn{}); }
+        };
+
+        struct values_or_stop_fn {
+            template<std::ranges::viewable_range R>
+            auto operator()(R &&r) const { return std::views::transform(take_while_ok_fn{}(std::forward<R>(r)), value_fn{}); }
+        };
+
+        // Pipe support for the adaptors above: range | adaptor, and adaptor composition with any other closure.
+        template<typename Func>
+        struct closure {
+            template<std::ranges::viewable_range R>
+                requires std::invocable<const Func &, R>
+            friend auto operator|(R &&r, const closure &c) { return c.func(std::forward<R>(r)); }
+
+            template<typename Left>
+                requires (!std::ranges::range<Left>)
+            friend auto operator|(Left left, const closure &c) {
+                return closure<composed<Left>>{{std::move(left), c}};
+            }
+
+            template<typename Left>
+            struct composed {
+                template<std::ranges::viewable_range R>
+                auto operator()(R &&r) const { return std::forward<R>(r) | left | right; }
+
+                Left left;
+                closure right;
+            };
+
+            Func func;
+        };
+    }
+
+    // Lazy adaptors over ranges of results, built from the standard views so they compose with them and with
+    // each other through operator|. None of them allocates; each element is visited as the consumer pulls it.
+    // Elements computed on the fly (after map_ok, and_then or any transform) are computed once per position.
+    namespace views {
+        template<typename Func>
+        constexpr auto map_ok(Func &&func) {
+            return std::views::transform(_r::map_ok_fn<std::decay_t<Func>>{std::forward<Func>(func)});
+        }
+
+        template<typename Func>
+        constexpr auto and_then(Func &&func) {
+            return std::views::transform(_r::and_then_fn<std::decay_t<Func>>{std::forward<Func>(func)});
+        }
+
+        inline constexpr _r::closure<_r::filter_ok_fn> filter_ok{};
+        inline constexpr _r::closure<_r::errors_fn> errors{};
+        inline constexpr _r::closure<_r::take_while_ok_fn> take_while_ok{};
+
+        // Values up to, not including, the first error.
+        inline constexpr _r::closure<_r::values_or_stop_fn> values_or_stop{};
+    }
+}
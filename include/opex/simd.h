@@ -0,0 +1,426 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <type_traits>
+
+#include <opex/opex.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define OPEX_SIMD_X86
+#include <immintrin.h>
+#endif
+
+namespace opex {
+    namespace simd {
+        enum class isa { scalar, sse2, avx2, avx512 };
+    }
+
+    namespace _simd {
+        // Kernels work on raw strided memory: element i has its discriminant at tags + i * stride and its value
+        // at values + i * stride. ok_mask handles at most 64 elements and sets bit i when element i holds a value.
+        using ok_mask_type = std::uint64_t (*)(const unsigned char *tags, std::size_t stride, std::size_t n);
+        using sum_f64_type = double (*)(const unsigned char *values, const unsigned char *tags, std::size_t stride, std::size_t n);
+        using sum_i64_type = std::uint64_t (*)(const unsigned char *values, const unsigned char *tags, std::size_t stride, std::size_t n);
+
+        struct kernels {
+            simd::isa isa;
+            ok_mask_type ok_mask;
+            sum_f64_type sum_f64;
+            sum_i64_type sum_i64;
+        };
+
+        inline std::int32_t tag_at(const unsigned char *tags, std::size_t stride, std::size_t i) noexcept {
+            std::int32_t tag;
+            std::memcpy(&tag, tags + i * stride, sizeof(tag));
+            return tag;
+        }
+
+        template<typename T>
+        T value_at(const unsigned char *values, std::size_t stride, std::size_t i) noexcept {
+            T value;
+            std::memcpy(&value, values + i * stride, sizeof(T));
+            return value;
+        }
+
+        inline std::uint64_t full_mask(std::size_t n) noexcept {
+            return n >= 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << n) - 1;
+        }
+
+        namespace scalar {
+            inline std::uint64_t ok_mask(const unsigned char *tags, std::size_t stride, std::size_t n) {
+                std::uint64_t mask = 0;
+                for (std::size_t i = 0; i < n; ++i)
+                    mask |= std::uint64_t(tag_at(tags, stride, i) == 0) << i;
+                return mask;
+            }
+
+            inline double sum_f64(const unsigned char *values, const unsigned char *tags, std::size_t stride, std::size_t n) {
+                double sum = 0;
+                for (std::size_t i = 0; i < n; ++i)
+                    if (tag_at(tags, stride, i) == 0)
+                        sum += value_at<double>(values, stride, i);
+                return sum;
+            }
+
+            inline std::uint64_t sum_i64(const unsigned char *values, const unsigned char *tags, std::size_t stride, std::size_t n) {
+                std::uint64_t sum = 0;
+                for (std::size_t i = 0; i < n; ++i)
+                    if (tag_at(tags, stride, i) == 0)
+                        sum += value_at<std::uint64_t>(values, stride, i);
+                return sum;
+            }
+
+            inline const kernels& table() noexcept {
+                static const kernels s_kernels = {simd::isa::scalar, &ok_mask, &sum_f64, &sum_i64};
+                return s_kernels;
+            }
+        }
+
+#ifdef OPEX_SIMD_X86
+        namespace sse2 {
+            __attribute__((target("sse2")))
+            inline __m128i tags4(const unsigned char *tags, std::size_t stride, std::size_t i) {
+                return _mm_setr_epi32(tag_at(tags, stride, i), tag_at(tags, stride, i + 1),
+                                      tag_at(tags, stride, i + 2), tag_at(tags, stride, i + 3));
+            }
+
+            __attribute__((target("sse2")))
+            inline std::uint64_t ok_mask(const unsigned char *tags, std::size_t stride, std::size_t n) {
+                std::uint64_t mask = 0;
+                std::size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    const auto ok = _mm_cmpeq_epi32(tags4(tags, stride, i), _mm_setzero_si128());
+                    mask |= std::uint64_t(_mm_movemask_ps(_mm_castsi128_ps(ok))) << i;
+                }
+                return i < n ? mask | scalar::ok_mask(tags + i * stride, stride, n - i) << i : mask;
+            }
+
+            __attribute__((target("sse2")))
+            inline double sum_f64(const unsigned char *values, const unsigned char *tags, std::size_t stride, std::size_t n) {
+                __m128d lo = _mm_setzero_pd(), hi = _mm_setzero_pd();
+                std::size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    const auto ok = _mm_cmpeq_epi32(tags4(tags, stride, i), _mm_setzero_si128());
+                    const auto v0 = _mm_setr_pd(value_at<double>(values, stride, i), value_at<double>(values, stride, i + 1));
+                    const auto v1 = _mm_setr_pd(value_at<double>(values, stride, i + 2), value_at<double>(values, stride, i + 3));
+                    lo = _mm_add_pd(lo, _mm_and_pd(v0, _mm_castsi128_pd(_mm_unpacklo_epi32(ok, ok))));
+                    hi = _mm_add_pd(hi, _mm_and_pd(v1, _mm_castsi128_pd(_mm_unpackhi_epi32(ok, ok))));
+                }
+                double lanes[2];
+                _mm_storeu_pd(lanes, _mm_add_pd(lo, hi));
+                return lanes[0] + lanes[1] + scalar::sum_f64(values + i * stride, tags + i * stride, stride, n - i);
+            }
+
+            __attribute__((target("sse2")))
+            inline std::uint64_t sum_i64(const unsigned char *values, const unsigned char *tags, std::size_t stride, std::size_t n) {
+                __m128i lo = _mm_setzero_si128(), hi = _mm_setzero_si128();
+                std::size_t i = 0;
+                for (; i + 4 <= n; i += 4) {
+                    const auto ok = _mm_cmpeq_epi32(tags4(tags, stride, i), _mm_setzero_si128());
+                    const auto v0 = _mm_set_epi64x(value_at<long long>(values, stride, i + 1), value_at<long long>(values, stride, i));
+                    const auto v1 = _mm_set_epi64x(value_at<long long>(values, stride, i + 3), value_at<long long>(values, stride, i + 2));
+                    lo = _mm_add_epi64(lo, _mm_and_si128(v0, _mm_unpacklo_epi32(ok, ok)));
+                    hi = _mm_add_epi64(hi, _mm_and_si128(v1, _mm_unpackhi_epi32(ok, ok)));
+                }
+                std::uint64_t lanes[2];
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), _mm_add_epi64(lo, hi));
+                return lanes[0] + lanes[1] + scalar::sum_i64(values + i * stride, tags + i * stride, stride, n - i);
+            }
+
+            inline const kernels& table() noexcept {
+                static const kernels s_kernels = {simd::isa::sse2, &ok_mask, &sum_f64, &sum_i64};
+                return s_kernels;
+            }
+        }
+
+        namespace avx2 {
+            __attribute__((target("avx2")))
+            inline std::uint64_t ok_mask(const unsigned char *tags, std::size_t stride, std::size_t n) {
+                const auto index = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                                      _mm256_set1_epi32(static_cast<int>(stride)));
+                std::uint64_t mask = 0;
+                std::size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    const auto t = _mm256_i32gather_epi32(reinterpret_cast<const int*>(tags + i * stride), index, 1);
+                    const auto ok = _mm256_cmpeq_epi32(t, _mm256_setzero_si256());
+                    mask |= std::uint64_t(_mm256_movemask_ps(_mm256_castsi256_ps(ok))) << i;
+                }
+                return i < n ? mask | scalar::ok_mask(tags + i * stride, stride, n - i) << i : mask;
+            }
+
+            // Strided values are loaded individually: on current cores four scalar loads beat a masked gather.
+            __attribute__((target("avx2")))
+            inline __m256i ok4(const unsigned char *tags, std::size_t stride, std::size_t i) {
+                const auto t = _mm_setr_epi32(tag_at(tags, stride, i), tag_at(tags, stride, i + 1),
+                                              tag_at(tags, stride, i + 2), tag_at(tags, stride, i + 3));
+                return _mm256_cvtepi32_epi64(_mm_cmpeq_epi32(t, _mm_setzero_si128()));
+            }
+
+            __attribute__((target("avx2")))
+            inline double sum_f64(const unsigned char *values, const unsigned char *tags, std::size_t stride, std::size_t n) {
+                auto lo = _mm256_setzero_pd(), hi = _mm256_setzero_pd();
+                std::size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    const auto v0 = _mm256_setr_pd(value_at<double>(values, stride, i), value_at<double>(values, stride, i + 1),
+                                                   value_at<double>(values, stride, i + 2), value_at<double>(values, stride, i + 3));
+                    const auto v1 = _mm256_setr_pd(value_at<double>(values, stride, i + 4), value_at<double>(values, stride, i + 5),
+                                                   value_at<double>(values, stride, i + 6), value_at<double>(values, stride, i + 7));
+                    lo = _mm256_add_pd(lo, _mm256_and_pd(v0, _mm256_castsi256_pd(ok4(tags, stride, i))));
+                    hi = _mm256_add_pd(hi, _mm256_and_pd(v1, _mm256_castsi256_pd(ok4(tags, stride, i + 4))));
+                }
+                double lanes[4];
+                _mm256_storeu_pd(lanes, _mm256_add_pd(lo, hi));
+                return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3])
+                     + scalar::sum_f64(values + i * stride, tags + i * stride, stride, n - i);
+            }
+
+            __attribute__((target("avx2")))
+            inline std::uint64_t sum_i64(const unsigned char *values, const unsigned char *tags, std::size_t stride, std::size_t n) {
+                auto lo = _mm256_setzero_si256(), hi = _mm256_setzero_si256();
+                std::size_t i = 0;
+                for (; i + 8 <= n; i += 8) {
+                    const auto v0 = _mm256_setr_epi64x(value_at<long long>(values, stride, i), value_at<long long>(values, stride, i + 1),
+                                                       value_at<long long>(values, stride, i + 2), value_at<long long>(values, stride, i + 3));
+                    const auto v1 = _mm256_setr_epi64x(value_at<long long>(values, stride, i + 4), value_at<long long>(values, stride, i + 5),
+                                                       value_at<long long>(values, stride, i + 6), value_at<long long>(values, stride, i + 7));
+                    lo = _mm256_add_epi64(lo, _mm256_and_si256(v0, ok4(tags, stride, i)));
+                    hi = _mm256_add_epi64(hi, _mm256_and_si256(v1, ok4(tags, stride, i + 4)));
+                }
+                std::uint64_t lanes[4];
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(lo, hi));
+                return lanes[0] + lanes[1] + lanes[2] + lanes[3]
+                     + scalar::sum_i64(values + i * stride, tags + i * stride, stride, n - i);
+            }
+
+            inline const kernels& table() noexcept {
+                static const kernels s_kernels = {simd::isa::avx2, &ok_mask, &sum_f64, &sum_i64};
+                return s_kernels;
+            }
+        }
+
+        namespace avx512 {
+            __attribute__((target("avx512f")))
+            inline __m512i index16(std::size_t stride) {
+                return _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+                                          _mm512_set1_epi32(static_cast<int>(stride)));
+            }
+
+            __attribute__((target("avx512f")))
+            inline std::uint64_t ok_mask(const unsigned char *tags, std::size_t stride, std::size_t n) {
+                const auto index = index16(stride);
+                std::uint64_t mask = 0;
+                std::size_t i = 0;
+                for (; i + 16 <= n; i += 16) {
+                    const auto t = _mm512_i32gather_epi32(index, tags + i * stride, 1);
+                    mask |= std::uint64_t(_mm512_cmpeq_epi32_mask(t, _mm512_setzero_si512())) << i;
+                }
+                return i < n ? mask | avx2::ok_mask(tags + i * stride, stride, n - i) << i : mask;
+            }
+
+            inline const kernels& table() noexcept {
+                // Sums are bound by the strided value loads; 512-bit accumulators measured no faster than AVX2.
+                static const kernels s_kernels = {simd::isa::avx512, &ok_mask, &avx2::sum_f64, &avx2::sum_i64};
+                return s_kernels;
+            }
+        }
+#endif
+
+        inline const kernels* table(simd::isa isa) noexcept {
+#ifdef OPEX_SIMD_X86
+            __builtin_cpu_init();
+#endif
+            switch (isa) {
+                case simd::isa::scalar:
+                    return &scalar::table();
+#ifdef OPEX_SIMD_X86
+                case simd::isa::sse2:
+                    return __builtin_cpu_supports("sse2") ? &sse2::table() : nullptr;
+                case simd::isa::avx2:
+                    return __builtin_cpu_supports("avx2") ? &avx2::table() : nullptr;
+                case simd::isa::avx512:
+                    return __builtin_cpu_supports("avx512f") ? &avx512::table() : nullptr;
+#endif
+                default:
+                    return nullptr;
+            }
+        }
+
+        inline const kernels* best() noexcept {
+            for (auto isa : {simd::isa::avx512, simd::isa::avx2, simd::isa::sse2})
+                if (const auto k = table(isa))
+                    return k;
+            return &scalar::table();
+        }
+
+        inline std::atomic<const kernels*>& selected() noexcept {
+            static std::atomic<const kernels*> s_selected{best()};
+            return s_selected;
+        }
+
+        inline const kernels& active() noexcept {
+            return *selected().load(std::memory_order_relaxed);
+        }
+
+        template<typename ResultType>
+        struct layout {
+            static_assert(_t::access::has_plain_tag<ResultType>(), "opex::simd needs a 32-bit result discriminant");
+
+            explicit layout(const ResultType *first) noexcept:
+                    tags(static_cast<const unsigned char*>(_t::access::tag_address(*first))),
+                    values(static_cast<const unsigned char*>(_t::access::value_address(*first)))
+            {}
+
+            static constexpr std::size_t stride = sizeof(ResultType);
+
+            const unsigned char *tags;
+            const unsigned char *values;
+        };
+
+        template<typename ResultType>
+        constexpr std::size_t layout<ResultType>::stride;
+
+        // Calls func(offset, mask) for consecutive blocks of up to 64 elements until it returns false.
+        template<typename ResultType, typename Func>
+        void for_each_block(const ResultType *first, std::size_t n, Func &&func) {
+            if (n == 0)
+                return;
+            const layout<ResultType> l{first};
+            const auto ok_mask = active().ok_mask;
+            for (std::size_t i = 0; i < n; i += 64) {
+                const auto count = n - i < 64 ? n - i : 64;
+                if (!func(i, ok_mask(l.tags + i * l.stride, l.stride, count), full_mask(count)))
+                    return;
+            }
+        }
+
+        inline unsigned popcount(std::uint64_t mask) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_popcountll(mask));
+#else
+            unsigned count = 0;
+            for (; mask; mask &= mask - 1)
+                ++count;
+            return count;
+#endif
+        }
+
+        inline unsigned lowest_bit(std::uint64_t mask) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_ctzll(mask));
+#else
+            unsigned index = 0;
+            for (; !(mask & 1); mask >>= 1)
+                ++index;
+            return index;
+#endif
+        }
+
+        enum class sum_kind { f64, i64, generic };
+
+        template<typename T>
+        struct sum_kind_of : std::integral_constant<sum_kind,
+                std::is_same<T, double>::value ? sum_kind::f64 :
+                std::is_integral<T>::value && sizeof(T) == 8 ? sum_kind::i64 : sum_kind::generic> {};
+
+        template<typename ResultType, typename T = typename ResultType::value_type, sum_kind = sum_kind_of<T>::value>
+        struct sum {
+            static T apply(const ResultType *first, std::size_t n) {
+                T total = T();
+                for (std::size_t i = 0; i < n; ++i)
+                    if (first[i].is_ok())
+                        total += first[i].unwrap();
+                return total;
+            }
+        };
+
+        template<typename ResultType, typename T>
+        struct sum<ResultType, T, sum_kind::f64> {
+            static T apply(const ResultType *first, std::size_t n) {
+                const layout<ResultType> l{first};
+                return active().sum_f64(l.values, l.tags, l.stride, n);
+            }
+        };
+
+        template<typename ResultType, typename T>
+        struct sum<ResultType, T, sum_kind::i64> {
+            static T apply(const ResultType *first, std::size_t n) {
+                const layout<ResultType> l{first};
+                return static_cast<T>(active().sum_i64(l.values, l.tags, l.stride, n));
+            }
+        };
+    }
+
+    namespace simd {
+        inline bool supported(isa i) noexcept { return _simd::table(i) != nullptr; }
+
+        inline isa best() noexcept { return _simd::best()->isa; }
+
+        inline isa active() noexcept { return _simd::active().isa; }
+
+        // Switches every bulk operation to the given instruction set; returns false if the CPU lacks it.
+        inline bool use(isa i) noexcept {
+            const auto k = _simd::table(i);
+            if (k)
+                _simd::selected().store(k, std::memory_order_relaxed);
+            return k != nullptr;
+        }
+
+        template<typename ValueType, typename ExceptionType, typename ErrorHandle>
+        std::size_t count_ok(const result<ValueType, ExceptionType, ErrorHandle> *first, std::size_t n) {
+            std::size_t count = 0;
+            _simd::for_each_block(first, n, [&](std::size_t, std::uint64_t ok, std::uint64_t) {
+                count += _simd::popcount(ok);
+                return true;
+            });
+            return count;
+        }
+
+        template<typename ValueType, typename ExceptionType, typename ErrorHandle>
+        bool all_ok(const result<ValueType, ExceptionType, ErrorHandle> *first, std::size_t n) {
+            bool all = true;
+            _simd::for_each_block(first, n, [&](std::size_t, std::uint64_t ok, std::uint64_t full) {
+                return all = ok == full;
+            });
+            return all;
+        }
+
+        // Returns n when every element holds a value.
+        template<typename ValueType, typename ExceptionType, typename ErrorHandle>
+        std::size_t first_error_index(const result<ValueType, ExceptionType, ErrorHandle> *first, std::size_t n) {
+            std::size_t index = n;
+            _simd::for_each_block(first, n, [&](std::size_t offset, std::uint64_t ok, std::uint64_t full) {
+                if (ok == full)
+                    return true;
+                index = offset + _simd::lowest_bit(~ok & full);
+                return false;
+            });
+            return index;
+        }
+
+        // Sums the values of all ok elements. double and 64-bit integer sums run vectorized; floating point lanes
+        // are accumulated separately, so the result can differ from a sequential loop in the last bits.
+        template<typename ValueType, typename ExceptionType, typename ErrorHandle>
+        ValueType sum_ok(const result<ValueType, ExceptionType, ErrorHandle> *first, std::size_t n) {
+            static_assert(std::is_arithmetic<ValueType>::value, "sum_ok needs an arithmetic value type");
+            if (n == 0)
+                return ValueType();
+            return _simd::sum<result<ValueType, ExceptionType, ErrorHandle>>::apply(first, n);
+        }
+
+        // Replaces the value of every ok element with func(value); errors are left untouched. func itself runs
+        // one element at a time, and a predicted branch on the discriminant measured faster than building masks.
+        template<typename Func, typename ValueType, typename ExceptionType, typename ErrorHandle>
+        void map(result<ValueType, ExceptionType, ErrorHandle> *first, std::size_t n, Func &&func) {
+            for (std::size_t i = 0; i < n; ++i) {
+                if (OPEX_LIKELY(first[i].is_ok())) {
+                    auto &value = _t::access::value(first[i]);
+                    value = func(static_cast<const ValueType&>(value));
+                }
+            }
+        }
+    }
+}
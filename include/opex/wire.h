@@ -0,0 +1,290 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
+#include <opex/opex.h>
+
+namespace opex {
+    namespace wire {
+        // Records are written in native byte order; they are meant for processes sharing a host.
+        //
+        //   header: 'O' 'X' version kind u32:body_size
+        //   ok:     value bytes (codec defined)
+        //   err:    u32:type_id u32:message_size message '\0' u32:fields_size fields
+
+        class decode_error : public std::runtime_error {
+        public:
+            explicit decode_error(const char *message): std::runtime_error(message) {}
+        };
+
+        class remote_error : public std::runtime_error {
+        public:
+            remote_error(std::uint32_t type_id, const std::string &message):
+                    std::runtime_error(message),
+                    m_type_id(type_id)
+            {}
+
+            std::uint32_t type_id() const noexcept { return m_type_id; }
+
+        private:
+            std::uint32_t m_type_id;
+        };
+
+        template<typename T, typename = void>
+        struct codec;
+
+        template<typename T>
+        struct codec<T, _t::enable_if_t<std::is_trivially_copyable<T>::value>> {
+            static std::size_t size(const T &) noexcept { return sizeof(T); }
+
+            static void encode(const T &value, unsigned char *out) noexcept {
+                std::memcpy(out, &value, sizeof(T));
+            }
+
+            static T decode(const unsigned char *in, std::size_t size) {
+                if (size != sizeof(T))
+                    throw decode_error("opex::wire: value size mismatch");
+                T value;
+                std::memcpy(&value, in, sizeof(T));
+                return value;
+            }
+        };
+
+        template<>
+        struct codec<std::string> {
+            static std::size_t size(const std::string &value) noexcept { return value.size(); }
+
+            static void encode(const std::string &value, unsigned char *out) noexcept {
+                std::memcpy(out, value.data(), value.size());
+            }
+
+            static std::string decode(const unsigned char *in, std::size_t size) {
+                return std::string(reinterpret_cast<const char*>(in), size);
+            }
+        };
+
+        namespace _w {
+            constexpr unsigned char magic0 = 'O';
+            constexpr unsigned char magic1 = 'X';
+            constexpr unsigned char version = 1;
+            constexpr std::size_t header_size = 8;
+
+            enum kind : unsigned char { ok = 0, err = 1 };
+
+            inline std::uint32_t get_u32(const unsigned char *p) noexcept {
+                std::uint32_t value;
+                std::memcpy(&value, p, sizeof(value));
+                return value;
+            }
+
+            inline void put_u32(std::vector<unsigned char> &out, std::size_t at, std::uint32_t value) noexcept {
+                std::memcpy(out.data() + at, &value, sizeof(value));
+            }
+
+            inline std::size_t begin(std::vector<unsigned char> &out, kind k, std::size_t body_size) {
+                if (body_size > UINT32_MAX)
+                    throw std::length_error("opex::wire: record too large");
+                const auto at = out.size();
+                out.resize(at + header_size + body_size);
+                out[at + 0] = magic0;
+                out[at + 1] = magic1;
+                out[at + 2] = version;
+                out[at + 3] = k;
+                put_u32(out, at + 4, static_cast<std::uint32_t>(body_size));
+                return at + header_size;
+            }
+        }
+
+        class view {
+        public:
+            view() noexcept: m_data(nullptr), m_size(0) {}
+
+            view(const void *data, std::size_t size) noexcept: view() {
+                const auto p = static_cast<const unsigned char*>(data);
+                if (size < _w::header_size || p[0] != _w::magic0 || p[1] != _w::magic1 || p[2] != _w::version)
+                    return;
+
+                const auto body_size = _w::get_u32(p + 4);
+                if (size - _w::header_size < body_size)
+                    return;
+                if (p[3] == _w::ok) {
+                    m_data = p;
+                    m_size = _w::header_size + body_size;
+                } else if (p[3] == _w::err && valid_error(p + _w::header_size, body_size)) {
+                    m_data = p;
+                    m_size = _w::header_size + body_size;
+                }
+            }
+
+            bool valid() const noexcept { return m_data != nullptr; }
+            std::size_t size() const noexcept { return m_size; }
+
+            bool is_ok() const noexcept  { return valid() && m_data[3] == _w::ok; }
+            bool is_err() const noexcept { return valid() && m_data[3] == _w::err; }
+
+            const unsigned char* value_data() const noexcept { return is_ok() ? body() : nullptr; }
+            std::size_t value_size() const noexcept { return is_ok() ? m_size - _w::header_size : 0; }
+
+            template<typename T, typename Codec = codec<T>>
+            T value() const {
+                if (!is_ok())
+                    throw decode_error("opex::wire: record does not hold a value");
+                return Codec::decode(value_data(), value_size());
+            }
+
+            std::uint32_t type_id() const noexcept { return is_err() ? _w::get_u32(body()) : 0; }
+            std::size_t message_size() const noexcept { return is_err() ? _w::get_u32(body() + 4) : 0; }
+            const char* message() const noexcept {
+                return is_err() ? reinterpret_cast<const char*>(body() + 8) : "";
+            }
+
+            const unsigned char* fields_data() const noexcept {
+                return is_err() ? body() + 8 + message_size() + 1 + 4 : nullptr;
+            }
+            std::size_t fields_size() const noexcept {
+                return is_err() ? _w::get_u32(body() + 8 + message_size() + 1) : 0;
+            }
+
+        private:
+            const unsigned char* body() const noexcept { return m_data + _w::header_size; }
+
+            static bool valid_error(const unsigned char *p, std::size_t size) noexcept {
+                if (size < 8)
+                    return false;
+                const std::size_t message_size = _w::get_u32(p + 4);
+                if (size - 8 < message_size + 1 + 4 || p[8 + message_size] != '\0')
+                    return false;
+                const std::size_t fields_size = _w::get_u32(p + 8 + message_size + 1);
+                return size - 8 - message_size - 1 - 4 == fields_size;
+            }
+
+            const unsigned char *m_data;
+            std::size_t m_size;
+        };
+
+        template<typename ExceptionType = std::exception>
+        class error_registry {
+            static_assert(std::is_base_of<std::exception, ExceptionType>::value,
+                          "opex::wire can only transport std::exception derived errors");
+
+        public:
+            using encode_fields_type = std::function<void(const ExceptionType &, std::vector<unsigned char> &)>;
+            using make_type = std::function<std::exception_ptr(const view &)>;
+
+            template<typename E>
+            error_registry& add(std::uint32_t id) {
+                return add<E>(id,
+                              [](const E &, std::vector<unsigned char> &) {},
+                              [](const view &v) { return E(v.message()); });
+            }
+
+            template<typename E, typename EncodeFields, typename Make>
+            error_registry& add(std::uint32_t id, EncodeFields encode_fields, Make make) {
+                static_assert(std::is_base_of<ExceptionType, E>::value, "registered errors must derive from the exception type");
+                if (id == 0)
+                    throw std::invalid_argument("opex::wire: type id 0 is reserved for unregistered errors");
+                if (find(id))
+                    throw std::invalid_argument("opex::wire: type id registered twice");
+
+                m_entries.push_back(entry{
+                        id,
+                        &typeid(E),
+                        [encode_fields](const ExceptionType &e, std::vector<unsigned char> &out) {
+                            encode_fields(static_cast<const E&>(e), out);
+                        },
+                        [make](const view &v) { return std::make_exception_ptr(make(v)); }
+                });
+                return *this;
+            }
+
+            template<typename Codec = void, typename ValueType, typename ErrorHandle>
+            void encode(const result<ValueType, ExceptionType, ErrorHandle> &r, std::vector<unsigned char> &out) const {
+                using codec_type = typename std::conditional<std::is_void<Codec>::value, codec<ValueType>, Codec>::type;
+
+                if (r.is_ok()) {
+                    const auto &value = r.unwrap();
+                    const auto at = _w::begin(out, _w::ok, codec_type::size(value));
+                    codec_type::encode(value, out.data() + at);
+                    return;
+                }
+
+                r.err_visit([&](const ExceptionType &e) { encode_error(e, out); });
+            }
+
+            template<typename ValueType, typename Codec = codec<ValueType>, typename ErrorHandle = shared_error_handle>
+            result<ValueType, ExceptionType, ErrorHandle> decode(const view &v) const {
+                using result_type = result<ValueType, ExceptionType, ErrorHandle>;
+
+                if (!v.valid())
+                    throw decode_error("opex::wire: malformed record");
+                if (v.is_ok())
+                    return result_type{v.value<ValueType, Codec>()};
+
+                if (const auto e = find(v.type_id()))
+                    return _t::access::from_exception_ptr<result_type>(e->make(v));
+                return unknown<result_type>(v);
+            }
+
+        private:
+            struct entry {
+                std::uint32_t id;
+                const std::type_info *type;
+                encode_fields_type encode_fields;
+                make_type make;
+            };
+
+            const entry* find(std::uint32_t id) const noexcept {
+                for (const auto &e : m_entries)
+                    if (e.id == id)
+                        return &e;
+                return nullptr;
+            }
+
+            const entry* find(const std::type_info &type) const noexcept {
+                for (const auto &e : m_entries)
+                    if (*e.type == type)
+                        return &e;
+                return nullptr;
+            }
+
+            void encode_error(const ExceptionType &e, std::vector<unsigned char> &out) const {
+                const auto registered = find(typeid(e));
+
+                std::vector<unsigned char> fields;
+                if (registered)
+                    registered->encode_fields(e, fields);
+
+                const auto message = e.what();
+                const auto message_size = std::strlen(message);
+                const auto at = _w::begin(out, _w::err, 4 + 4 + message_size + 1 + 4 + fields.size());
+                _w::put_u32(out, at, registered ? registered->id : 0);
+                _w::put_u32(out, at + 4, static_cast<std::uint32_t>(message_size));
+                std::memcpy(out.data() + at + 8, message, message_size + 1);
+                _w::put_u32(out, at + 8 + message_size + 1, static_cast<std::uint32_t>(fields.size()));
+                if (!fields.empty())
+                    std::memcpy(out.data() + at + 8 + message_size + 1 + 4, fields.data(), fields.size());
+            }
+
+            template<typename ResultType,
+                     _t::enable_if_t<std::is_base_of<typename ResultType::exception_type, remote_error>::value>* = nullptr>
+            static ResultType unknown(const view &v) {
+                return ResultType::from_exception(remote_error{v.type_id(), std::string(v.message(), v.message_size())});
+            }
+
+            template<typename ResultType,
+                     _t::enable_if_t<!std::is_base_of<typename ResultType::exception_type, remote_error>::value>* = nullptr>
+            static ResultType unknown(const view &) {
+                throw decode_error("opex::wire: unregistered error type");
+            }
+
+            std::vector<entry> m_entries;
+        };
+    }
+}
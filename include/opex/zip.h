@@ -0,0 +1,73 @@
+#pragma once
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <opex/opex.h>
+
+namespace opex {
+    namespace _z {
+        template<typename R> using bare_t = typename std::decay<R>::type;
+
+        inline bool all_ok() noexcept { return true; }
+
+        template<typename R, typename... Rs>
+        bool all_ok(const R &r, const Rs &... rs) noexcept { return r.is_ok() && all_ok(rs...); }
+
+        template<typename... Rs> struct same_error;
+
+        template<typename R>
+        struct same_error<R> : std::true_type {};
+
+        template<typename R, typename S, typename... Rs>
+        struct same_error<R, S, Rs...> : std::integral_constant<bool,
+                std::is_same<typename R::exception_type, typename S::exception_type>::value &&
+                std::is_same<typename R::error_handle, typename S::error_handle>::value &&
+                same_error<S, Rs...>::value> {};
+
+        template<typename ResultType, typename R>
+        OPEX_COLD ResultType first_error(R &&r) {
+            return _t::access::forward_error<ResultType>(std::forward<R>(r));
+        }
+
+        template<typename ResultType, typename R, typename S, typename... Rs>
+        OPEX_COLD ResultType first_error(R &&r, S &&s, Rs &&... rs) {
+            return r.is_err() ? _t::access::forward_error<ResultType>(std::forward<R>(r))
+                              : first_error<ResultType>(std::forward<S>(s), std::forward<Rs>(rs)...);
+        }
+    }
+
+    // zip and apply check every argument before touching a value. When several arguments hold errors, the
+    // leftmost one wins. Values are moved out of rvalue arguments and copied from lvalues.
+    template<typename R, typename... Rs,
+             _t::enable_if_t<is_result<_z::bare_t<R>>::value>* = nullptr,
+             typename ResultType = result<std::tuple<typename _z::bare_t<R>::value_type, typename _z::bare_t<Rs>::value_type...>,
+                                          typename _z::bare_t<R>::exception_type,
+                                          typename _z::bare_t<R>::error_handle>>
+    ResultType zip(R &&r, Rs &&... rs) {
+        static_assert(_z::same_error<_z::bare_t<R>, _z::bare_t<Rs>...>::value,
+                      "zip needs results with the same exception type and error handle");
+
+        if (OPEX_LIKELY(_z::all_ok(r, rs...)))
+            return _t::access::emplace<ResultType>(_t::access::value(std::forward<R>(r)),
+                                                   _t::access::value(std::forward<Rs>(rs))...);
+        return _z::first_error<ResultType>(std::forward<R>(r), std::forward<Rs>(rs)...);
+    }
+
+    template<typename Func, typename R, typename... Rs,
+             _t::enable_if_t<is_result<_z::bare_t<R>>::value>* = nullptr,
+             typename ResultType = result<_t::call_result_t<Func, decltype(_t::access::value(std::declval<R>())),
+                                                                  decltype(_t::access::value(std::declval<Rs>()))...>,
+                                          typename _z::bare_t<R>::exception_type,
+                                          typename _z::bare_t<R>::error_handle>>
+    ResultType apply(Func &&func, R &&r, Rs &&... rs) {
+        static_assert(_z::same_error<_z::bare_t<R>, _z::bare_t<Rs>...>::value,
+                      "apply needs results with the same exception type and error handle");
+
+        if (OPEX_LIKELY(_z::all_ok(r, rs...)))
+            return _t::access::invoke<ResultType>(func, _t::access::value(std::forward<R>(r)),
+                                                 _t::access::value(std::forward<Rs>(rs))...);
+        return _z::first_error<ResultType>(std::forward<R>(r), std::forward<Rs>(rs)...);
+    }
+}
@@ -2,6 +2,7 @@
 
 namespace gear {
     unsigned TestType::s_instanceid = 0;
+    Counts CountedType::s_counts = {};
 
     gear::TestType throw_if_true(bool b) {
         if (b)
@@ -5,6 +5,10 @@
 
 #include <opex/opex.h>
 
+#ifdef OPEX_TEST_VALUE_BACKEND
+#include <opex/expected.h>
+#endif
+
 
 namespace gear {
     class TestType {
@@ -58,6 +62,59 @@ namespace gear {
         }
     };
 
+    struct Counts {
+        unsigned copies;
+        unsigned moves;
+        unsigned copy_assigns;
+        unsigned move_assigns;
+        unsigned destructs;
+    };
+
+    // Counts every special member call across all instances; reset() before the operation under test.
+    class CountedType {
+        static Counts s_counts;
+
+    public:
+        static void reset() noexcept { s_counts = Counts{}; }
+        static const Counts& counts() noexcept { return s_counts; }
+
+        explicit CountedType(int value = 0): m_value(value)
+        {}
+
+        CountedType(const CountedType &other): m_value(other.m_value)
+        {
+            ++s_counts.copies;
+        }
+
+        CountedType(CountedType &&other) noexcept: m_value(other.m_value)
+        {
+            ++s_counts.moves;
+        }
+
+        CountedType& operator=(const CountedType &other) {
+            m_value = other.m_value;
+            ++s_counts.copy_assigns;
+            return *this;
+        }
+
+        CountedType& operator=(CountedType &&other) noexcept {
+            m_value = other.m_value;
+            ++s_counts.move_assigns;
+            return *this;
+        }
+
+        ~CountedType() {
+            ++s_counts.destructs;
+        }
+
+        int value() const noexcept {
+            return m_value;
+        }
+
+    private:
+        int m_value;
+    };
+
     class TestException : public std::runtime_error {
     public:
         explicit TestException(const char *message):
@@ -65,7 +122,28 @@ namespace gear {
         {}
     };
 
-    using TestResult = opex::result<gear::TestType, gear::TestException>;
+    // The combinator tests build against backend_result, so test_opex_value_backend can run them over the
+    // std::expected backend as well as the default one.
+#ifdef OPEX_TEST_VALUE_BACKEND
+    template<typename ValueType, typename ExceptionType = std::exception>
+    using backend_result = opex::value_result<ValueType, ExceptionType>;
+
+    template<typename ExceptionType = std::exception, typename Func>
+    backend_result<opex::_t::call_result_t<Func>, ExceptionType> backend_call(Func &&func) {
+        return backend_result<opex::_t::call_result_t<Func>, ExceptionType>::call(std::forward<Func>(func));
+    }
+#else
+    template<typename ValueType, typename ExceptionType = std::exception>
+    using backend_result = opex::result<ValueType, ExceptionType>;
+
+    template<typename ExceptionType = std::exception, typename Func>
+    backend_result<opex::_t::call_result_t<Func>, ExceptionType> backend_call(Func &&func) {
+        return opex::call<ExceptionType>(std::forward<Func>(func));
+    }
+#endif
+
+    using TestResult = backend_result<gear::TestType, gear::TestException>;
+    using CountedResult = opex::result<gear::CountedType, gear::TestException>;
 
     gear::TestType throw_if_true(bool b);
 }
@@ -0,0 +1,143 @@
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <opex/aggregate.h>
+
+#include "gear.h"
+
+namespace {
+    int parse(int i) {
+        if (i % 3 == 0)
+            throw gear::TestException("multiple of three");
+        if (i % 5 == 0)
+            throw std::out_of_range("multiple of five");
+        return i * 2;
+    }
+
+    // Counts how often the aggregate reads an error's message.
+    struct counted_error : std::runtime_error {
+        explicit counted_error(int &reads): std::runtime_error("counted"), reads(&reads) {}
+
+        const char* what() const noexcept override {
+            ++*reads;
+            return std::runtime_error::what();
+        }
+
+        int *reads;
+    };
+}
+
+TEST(Aggregate, AllOk)
+{
+    const std::vector<int> input{1, 2, 4, 7};
+    const auto result = opex::call_each(input, parse);
+
+    EXPECT_TRUE(result.is_ok());
+    EXPECT_EQ((std::vector<int>{2, 4, 8, 14}), result.unwrap());
+}
+
+TEST(Aggregate, CollectsAllErrors)
+{
+    const std::vector<int> input{1, 3, 5, 6, 7, 10};
+    const auto result = opex::call_each(input, parse);
+
+    ASSERT_TRUE(result.is_err());
+    result.err_visit([](const opex::aggregate_error &errors) {
+        EXPECT_EQ(4u, errors.size());
+        EXPECT_EQ(2u, errors.count<gear::TestException>());
+        EXPECT_EQ(2u, errors.count<std::out_of_range>());
+        EXPECT_EQ(0u, errors.count<std::runtime_error>());
+
+        std::vector<std::size_t> indices;
+        for (const auto &e : errors)
+            indices.push_back(e.index());
+        EXPECT_EQ((std::vector<std::size_t>{1, 2, 3, 5}), indices);
+
+        EXPECT_STREQ("multiple of three", errors[0].what());
+        EXPECT_STREQ("multiple of five", errors[1].what());
+        EXPECT_TRUE(errors[1].type() == typeid(std::out_of_range));
+    });
+}
+
+TEST(Aggregate, OnlyCatchesExceptionType)
+{
+    const std::vector<int> input{3, 5};
+
+    EXPECT_THROW(opex::call_each<gear::TestException>(input, parse), std::out_of_range);
+}
+
+TEST(Aggregate, What)
+{
+    const std::vector<int> input{1, 2, 3};
+    const auto result = opex::call_each(input, parse);
+
+    ASSERT_TRUE(result.is_err());
+    const auto what = result.what();
+    EXPECT_EQ(0u, what.find("1 error (1 x "));
+    EXPECT_NE(std::string::npos, what.find("gear::TestException)"));
+    EXPECT_NE(std::string::npos, what.find("first at [2]: multiple of three"));
+}
+
+TEST(Aggregate, AddResult)
+{
+    opex::aggregate_error errors;
+    errors.add(0, gear::TestResult{gear::TestType{}});
+    errors.add(1, gear::TestResult::make_exception<gear::TestException>("failed"));
+
+    ASSERT_EQ(1u, errors.size());
+    EXPECT_EQ(1u, errors[0].index());
+    EXPECT_STREQ("failed", errors[0].what());
+}
+
+TEST(Aggregate, InspectsErrorsOnlyWhenAsked)
+{
+    int reads = 0;
+    const std::vector<int> input(100, 0);
+    const auto result = opex::call_each(input, [&reads](int) -> int { throw counted_error(reads); });
+
+    ASSERT_TRUE(result.is_err());
+    result.err_visit([&reads](const opex::aggregate_error &errors) {
+        EXPECT_EQ(100u, errors.size());
+        EXPECT_EQ(0, reads);
+
+        EXPECT_EQ(100u, errors.count<counted_error>());
+        EXPECT_EQ(100, reads);
+
+        EXPECT_STREQ("counted", errors[99].what());
+        EXPECT_EQ(0u, std::string{errors.what()}.find("100 errors"));
+        EXPECT_EQ(100, reads);
+    });
+}
+
+TEST(Aggregate, KeepsOrderAcrossAddKinds)
+{
+    opex::aggregate_error errors;
+    errors.add(0, std::runtime_error{"zero"});
+    errors.add(1, gear::TestResult::make_exception<gear::TestException>("one"));
+    errors.add(2, std::out_of_range{"two"});
+
+    ASSERT_EQ(3u, errors.size());
+    EXPECT_STREQ("zero", errors[0].what());
+    EXPECT_STREQ("one", errors[1].what());
+    EXPECT_TRUE(errors[1].type() == typeid(gear::TestException));
+    EXPECT_STREQ("two", errors[2].what());
+
+    errors.add(3, gear::TestResult::make_exception<gear::TestException>("three"));
+    EXPECT_EQ(2u, errors.count<gear::TestException>());
+    EXPECT_STREQ("three", errors[3].what());
+}
+
+TEST(Aggregate, CopyAndMove)
+{
+    opex::aggregate_error errors;
+    errors.add(7, std::runtime_error{"seven"});
+    const std::string what = errors.what();
+
+    const auto copy = errors;
+    EXPECT_EQ(what, copy.what());
+
+    const auto moved = std::move(errors);
+    EXPECT_EQ(what, moved.what());
+    EXPECT_STREQ("seven", moved[0].what());
+}
@@ -92,3 +92,33 @@ TEST(AndSelect, RValueErr)
     EXPECT_EQ(expected, make_exception(expected.c_str()).and_select(rhs_clvalue).what());
     EXPECT_EQ(expected, make_exception(expected.c_str()).and_select(result_t{gear::TestType{unexpected}}).what());
 }
+
+TEST(AndSelectWith, Value)
+{
+    const gear::TestType expected{};
+    result_t lhs{gear::TestType{}};
+    const result_t clhs{gear::TestType{}};
+
+    int calls = 0;
+    const auto alternative = [&] { ++calls; return result_t{expected}; };
+
+    EXPECT_EQ(expected, lhs.and_select_with(alternative).unwrap());
+    EXPECT_EQ(expected, clhs.and_select_with(alternative).unwrap());
+    EXPECT_EQ(expected, result_t{gear::TestType{}}.and_select_with(alternative).unwrap());
+    EXPECT_EQ(3, calls);
+}
+
+TEST(AndSelectWith, Err)
+{
+    const auto expected = std::string{"expected"};
+    result_t lhs = make_exception(expected.c_str());
+    const result_t clhs = make_exception(expected.c_str());
+
+    int calls = 0;
+    const auto alternative = [&] { ++calls; return result_t{gear::TestType{}}; };
+
+    EXPECT_EQ(expected, lhs.and_select_with(alternative).what());
+    EXPECT_EQ(expected, clhs.and_select_with(alternative).what());
+    EXPECT_EQ(expected, make_exception(expected.c_str()).and_select_with(alternative).what());
+    EXPECT_EQ(0, calls);
+}
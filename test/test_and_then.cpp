@@ -4,7 +4,7 @@
 #include "gear.h"
 
 namespace {
-    using result_type = opex::result<gear::TestType, gear::TestException>;
+    using result_type = gear::TestResult;
 
     result_type my_opex_enabled_function(bool fail) {
         if (fail)
@@ -19,7 +19,12 @@ namespace {
         OtherType(gear::TestType v): nested(std::move(v))
         {}
     };
-    using other_result_type = opex::result<OtherType, std::exception>;
+#ifdef OPEX_TEST_VALUE_BACKEND
+    // and_then keeps the error type on the value backend instead of widening it.
+    using other_result_type = gear::backend_result<OtherType, gear::TestException>;
+#else
+    using other_result_type = gear::backend_result<OtherType, std::exception>;
+#endif
     
     template <typename T>
     other_result_type nest_value(T &&v) {
@@ -0,0 +1,167 @@
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <opex/async.h>
+
+#include "gear.h"
+
+namespace {
+    using promise_t = opex::promise<int, gear::TestException>;
+    using async_t = opex::async_result<int, gear::TestException>;
+    using result_t = opex::result<int, gear::TestException>;
+}
+
+TEST(Async, ReadyBeforeGet)
+{
+    promise_t p;
+    auto f = p.get_async_result();
+    p.set_value(3);
+
+    EXPECT_TRUE(f.is_ready());
+    EXPECT_EQ(3, std::move(f).get().unwrap());
+    EXPECT_FALSE(f.valid());
+}
+
+TEST(Async, ContinuationsRunOnCompletion)
+{
+    promise_t p;
+    std::vector<int> seen;
+    auto f = p.get_async_result()
+            .map([&](int i) { seen.push_back(i); return i + 1; })
+            .and_then([&](int i) { seen.push_back(i); return result_t{i * 2}; });
+
+    EXPECT_TRUE(seen.empty());
+    EXPECT_FALSE(f.is_ready());
+
+    p.set_value(1);
+    EXPECT_EQ(std::vector<int>({1, 2}), seen);
+    EXPECT_EQ(4, std::move(f).get().unwrap());
+}
+
+TEST(Async, ErrorSkipsValueContinuations)
+{
+    promise_t p;
+    int calls = 0;
+    auto f = p.get_async_result()
+            .map([&](int i) { ++calls; return i; })
+            .or_else([](const gear::TestException &e) { return result_t{static_cast<int>(std::string{e.what()}.size())}; });
+
+    p.set_exception<gear::TestException>("four");
+    EXPECT_EQ(4, std::move(f).get().unwrap());
+    EXPECT_EQ(0, calls);
+}
+
+TEST(Async, MapErr)
+{
+    promise_t p;
+    auto f = p.get_async_result().map_err([](const gear::TestException &e) {
+        return std::logic_error(std::string{"wrapped: "} + e.what());
+    });
+    p.set_exception<gear::TestException>("failed");
+
+    const auto r = std::move(f).get();
+    EXPECT_EQ("wrapped: failed", r.what());
+    EXPECT_TRUE(r.err_visit([](const std::logic_error &) { return true; }));
+}
+
+TEST(Async, CapturesThrownExceptions)
+{
+    promise_t p;
+    auto f = p.get_async_result().map([](int) -> int { throw gear::TestException("thrown"); });
+    p.set_value(1);
+
+    const auto r = std::move(f).get();
+    EXPECT_TRUE(r.is_err());
+    EXPECT_EQ("thrown", r.what());
+}
+
+TEST(Async, AndThenFlattensAsyncResults)
+{
+    promise_t outer;
+    promise_t inner;
+    auto f = outer.get_async_result().and_then([&](int i) {
+        return inner.get_async_result().map([i](int j) { return i + j; });
+    });
+
+    outer.set_value(1);
+    EXPECT_FALSE(f.is_ready());
+    inner.set_value(2);
+    EXPECT_EQ(3, std::move(f).get().unwrap());
+}
+
+TEST(Async, BrokenPromise)
+{
+    opex::async_result<int> f = [] {
+        opex::promise<int> p;
+        return p.get_async_result();
+    }();
+
+    const auto r = std::move(f).get();
+    EXPECT_TRUE(r.err_visit([](const std::exception &e) {
+        return dynamic_cast<const opex::broken_promise*>(&e) != nullptr;
+    }));
+}
+
+TEST(Async, Misuse)
+{
+    promise_t p;
+    auto f = p.get_async_result();
+    EXPECT_THROW(p.get_async_result(), std::logic_error);
+
+    p.set_value(1);
+    EXPECT_THROW(p.set_value(2), std::logic_error);
+
+    auto moved = std::move(f);
+    EXPECT_THROW(std::move(f).get(), std::logic_error);
+    EXPECT_EQ(1, std::move(moved).get().unwrap());
+}
+
+TEST(Async, ExecutorRunsContinuations)
+{
+    opex::thread_pool pool{2};
+    promise_t p;
+    const auto caller = std::this_thread::get_id();
+
+    auto f = p.get_async_result()
+            .map([&](int i) { EXPECT_NE(caller, std::this_thread::get_id()); return i + 1; }, pool)
+            .map([](int i) { return std::to_string(i); });
+    p.set_value(41);
+
+    EXPECT_EQ("42", std::move(f).get().unwrap());
+}
+
+TEST(Async, AsyncCall)
+{
+    opex::thread_pool pool{1};
+
+    auto ok = opex::async<gear::TestException>(pool, [] { return 5; });
+    auto failed = opex::async<gear::TestException>(pool, []() -> int { throw gear::TestException("async"); });
+
+    EXPECT_EQ(5, std::move(ok).get().unwrap());
+    EXPECT_EQ("async", std::move(failed).get().what());
+}
+
+TEST(Async, ManyChains)
+{
+    constexpr int chains = 2000;
+    opex::thread_pool pool{4};
+
+    std::vector<async_t> pending;
+    for (int i = 0; i < chains; ++i) {
+        pending.push_back(opex::async<gear::TestException>(pool, [i] { return i; })
+                .map([](int v) { return v * 2; }, pool)
+                .and_then([](int v) { return v % 7 ? result_t{v} : result_t::make_exception<gear::TestException>("seven"); })
+                .or_else([](const gear::TestException &) { return result_t{-1}; }, pool));
+    }
+
+    long sum = 0;
+    long expected = 0;
+    for (int i = 0; i < chains; ++i) {
+        sum += std::move(pending[i]).get().unwrap();
+        expected += (i * 2) % 7 ? i * 2 : -1;
+    }
+    EXPECT_EQ(expected, sum);
+}
@@ -0,0 +1,252 @@
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <opex/breaker.h>
+
+namespace {
+    struct FakeClock {
+        using duration = std::chrono::milliseconds;
+        using rep = duration::rep;
+        using period = duration::period;
+        using time_point = std::chrono::time_point<FakeClock>;
+        static constexpr bool is_steady = true;
+
+        static time_point now() noexcept { return time_point{s_now}; }
+
+        static duration s_now;
+    };
+
+    FakeClock::duration FakeClock::s_now{0};
+
+    using breaker_t = opex::circuit_breaker<FakeClock>;
+
+    struct Stub {
+        int *calls;
+        bool fail;
+
+        int operator()() const {
+            ++*calls;
+            if (fail)
+                throw std::runtime_error("backend down");
+            return 1;
+        }
+    };
+
+    breaker_t::options small_window() {
+        breaker_t::options o;
+        o.failure_threshold = 0.5;
+        o.minimum_calls = 4;
+        o.window = std::chrono::milliseconds(1000);
+        o.buckets = 10;
+        o.open_for = std::chrono::milliseconds(500);
+        return o;
+    }
+
+    bool is_open_error(const opex::result<int> &r) {
+        return r.is_err() && r.err_visit([](const std::exception &e) {
+            return dynamic_cast<const opex::circuit_open*>(&e) != nullptr;
+        });
+    }
+}
+
+TEST(CircuitBreaker, StaysClosedBelowMinimumCalls)
+{
+    breaker_t breaker{small_window()};
+    int calls = 0;
+
+    for (int i = 0; i < 3; ++i)
+        EXPECT_EQ("backend down", breaker.call(Stub{&calls, true}).what());
+
+    EXPECT_EQ(breaker_t::state::closed, breaker.current_state());
+    EXPECT_DOUBLE_EQ(1.0, breaker.error_rate());
+}
+
+TEST(CircuitBreaker, OpensAndFailsFast)
+{
+    breaker_t breaker{small_window()};
+    int calls = 0;
+
+    breaker.call(Stub{&calls, false});
+    breaker.call(Stub{&calls, false});
+    breaker.call(Stub{&calls, true});
+    EXPECT_EQ(breaker_t::state::closed, breaker.current_state());
+    breaker.call(Stub{&calls, true});
+    EXPECT_EQ(breaker_t::state::open, breaker.current_state());
+
+    const auto r = breaker.call(Stub{&calls, false});
+    EXPECT_TRUE(is_open_error(r));
+    EXPECT_EQ(4, calls);
+}
+
+TEST(CircuitBreaker, OldFailuresLeaveTheWindow)
+{
+    breaker_t breaker{small_window()};
+    int calls = 0;
+
+    for (int i = 0; i < 3; ++i)
+        breaker.call(Stub{&calls, true});
+    FakeClock::s_now += std::chrono::milliseconds(1000);
+
+    for (int i = 0; i < 3; ++i)
+        breaker.call(Stub{&calls, false});
+    breaker.call(Stub{&calls, true});
+
+    EXPECT_EQ(breaker_t::state::closed, breaker.current_state());
+    EXPECT_DOUBLE_EQ(0.25, breaker.error_rate());
+}
+
+TEST(CircuitBreaker, ProbeRecovers)
+{
+    breaker_t breaker{small_window()};
+    int calls = 0;
+
+    for (int i = 0; i < 4; ++i)
+        breaker.call(Stub{&calls, true});
+    ASSERT_EQ(breaker_t::state::open, breaker.current_state());
+
+    FakeClock::s_now += std::chrono::milliseconds(499);
+    EXPECT_TRUE(is_open_error(breaker.call(Stub{&calls, false})));
+
+    FakeClock::s_now += std::chrono::milliseconds(1);
+    EXPECT_EQ(1, breaker.call(Stub{&calls, false}).unwrap());
+    EXPECT_EQ(breaker_t::state::closed, breaker.current_state());
+    EXPECT_DOUBLE_EQ(0.0, breaker.error_rate());
+
+    breaker.call(Stub{&calls, true});
+    EXPECT_EQ(breaker_t::state::closed, breaker.current_state());
+}
+
+TEST(CircuitBreaker, FailedProbeReopens)
+{
+    breaker_t breaker{small_window()};
+    int calls = 0;
+
+    for (int i = 0; i < 4; ++i)
+        breaker.call(Stub{&calls, true});
+    FakeClock::s_now += std::chrono::milliseconds(500);
+
+    EXPECT_EQ("backend down", breaker.call(Stub{&calls, true}).what());
+    EXPECT_EQ(breaker_t::state::open, breaker.current_state());
+    EXPECT_TRUE(is_open_error(breaker.call(Stub{&calls, false})));
+    EXPECT_EQ(5, calls);
+}
+
+TEST(CircuitBreaker, SlowFailuresOpenWhenTheyComplete)
+{
+    breaker_t breaker{small_window()};
+    int calls = 0;
+    const auto start = FakeClock::s_now;
+
+    for (int i = 0; i < 3; ++i)
+        breaker.call(Stub{&calls, true});
+
+    breaker.call([&]() -> int {
+        FakeClock::s_now += std::chrono::milliseconds(300);
+        throw std::runtime_error("timed out");
+    });
+    ASSERT_EQ(breaker_t::state::open, breaker.current_state());
+    EXPECT_TRUE(is_open_error(breaker.call(Stub{&calls, false})));
+
+    FakeClock::s_now = start + std::chrono::milliseconds(799);
+    EXPECT_TRUE(is_open_error(breaker.call(Stub{&calls, false})));
+
+    FakeClock::s_now = start + std::chrono::milliseconds(800);
+    EXPECT_EQ(1, breaker.call(Stub{&calls, false}).unwrap());
+    EXPECT_EQ(breaker_t::state::closed, breaker.current_state());
+}
+
+TEST(CircuitBreaker, LateFailuresKeepTheCoolDown)
+{
+    breaker_t breaker{small_window()};
+    int calls = 0;
+    const auto start = FakeClock::s_now;
+
+    for (int i = 0; i < 3; ++i)
+        breaker.call(Stub{&calls, true});
+
+    // A slow call starts while the breaker is closed and only fails once it has opened at 100.
+    std::promise<void> started, finish;
+    std::thread slow([&] {
+        breaker.call([&]() -> int {
+            started.set_value();
+            finish.get_future().wait();
+            throw std::runtime_error("backend down");
+        });
+    });
+    started.get_future().wait();
+
+    FakeClock::s_now = start + std::chrono::milliseconds(100);
+    breaker.call(Stub{&calls, true});
+    ASSERT_EQ(breaker_t::state::open, breaker.current_state());
+
+    FakeClock::s_now = start + std::chrono::milliseconds(300);
+    finish.set_value();
+    slow.join();
+    EXPECT_EQ(breaker_t::state::open, breaker.current_state());
+
+    FakeClock::s_now = start + std::chrono::milliseconds(599);
+    EXPECT_TRUE(is_open_error(breaker.call(Stub{&calls, false})));
+
+    FakeClock::s_now = start + std::chrono::milliseconds(600);
+    EXPECT_EQ(1, breaker.call(Stub{&calls, false}).unwrap());
+    EXPECT_EQ(breaker_t::state::closed, breaker.current_state());
+}
+
+TEST(CircuitBreaker, StaleSamplesKeepNewerCounts)
+{
+    opex::_b::counter counter;
+    counter.add(5);
+    counter.add(5);
+
+    counter.add(4);
+    EXPECT_EQ(2u, counter.count(5, 5));
+    EXPECT_EQ(0u, counter.count(4, 4));
+
+    counter.add(6);
+    EXPECT_EQ(1u, counter.count(6, 6));
+    EXPECT_EQ(0u, counter.count(5, 5));
+}
+
+TEST(CircuitBreaker, LimitsConcurrentProbes)
+{
+    breaker_t breaker{small_window()};
+    int calls = 0;
+
+    for (int i = 0; i < 4; ++i)
+        breaker.call(Stub{&calls, true});
+    FakeClock::s_now += std::chrono::milliseconds(500);
+
+    std::vector<opex::result<int>> nested;
+    const auto probe = breaker.call([&] {
+        nested.push_back(breaker.call(Stub{&calls, false}));
+        return 2;
+    });
+
+    EXPECT_EQ(2, probe.unwrap());
+    EXPECT_TRUE(is_open_error(nested.at(0)));
+    EXPECT_EQ(breaker_t::state::closed, breaker.current_state());
+}
+
+TEST(CircuitBreaker, ConcurrentCalls)
+{
+    breaker_t::options o = small_window();
+    o.minimum_calls = 1000000;
+    breaker_t breaker{o};
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&breaker, t] {
+            int calls = 0;
+            for (int i = 0; i < 1000; ++i)
+                breaker.call(Stub{&calls, (i + t) % 4 == 0});
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+
+    EXPECT_DOUBLE_EQ(0.25, breaker.error_rate());
+}
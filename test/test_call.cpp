@@ -1,13 +1,15 @@
 #include <functional>
+#include <type_traits>
 
 #include <gtest/gtest.h>
+#include <opex/fault.h>
 #include <opex/opex.h>
 
 #include "gear.h"
 
 TEST(Call, Value)
 {
-    const opex::result<gear::TestType> result = opex::call(std::bind(gear::throw_if_true, false));
+    const gear::backend_result<gear::TestType> result = gear::backend_call(std::bind(gear::throw_if_true, false));
 
     EXPECT_TRUE(result.is_ok());
     ASSERT_NO_THROW(result.unwrap());
@@ -16,25 +18,44 @@ TEST(Call, Value)
 
 TEST(Call, ValueExplicitExceptionType)
 {
-    const gear::TestResult result = opex::call<gear::TestException>(std::bind(gear::throw_if_true, false));
+    const gear::TestResult result = gear::backend_call<gear::TestException>(std::bind(gear::throw_if_true, false));
 
     EXPECT_TRUE(result.is_ok());
     ASSERT_NO_THROW(result.unwrap());
     EXPECT_TRUE(result.unwrap().valid());
 }
 
+#ifndef OPEX_TEST_VALUE_BACKEND
+// On the value backend a std::exception result keeps only the std::exception part of what was thrown.
 TEST(Call, Except)
 {
-    const opex::result<gear::TestType> result = opex::call(std::bind(gear::throw_if_true, true));
+    const gear::backend_result<gear::TestType> result = gear::backend_call(std::bind(gear::throw_if_true, true));
 
     EXPECT_TRUE(result.is_err());
     EXPECT_THROW(result.unwrap(), gear::TestException);
 }
+#endif
 
 TEST(Call, ExceptExplicitExceptionType)
 {
-    const gear::TestResult result = opex::call<gear::TestException>(std::bind(gear::throw_if_true, true));
+    const gear::TestResult result = gear::backend_call<gear::TestException>(std::bind(gear::throw_if_true, true));
 
     EXPECT_TRUE(result.is_err());
     EXPECT_THROW(result.unwrap(), gear::TestException);
 }
+
+#ifndef OPEX_TEST_VALUE_BACKEND
+TEST(Call, FaultSiteIsInertByDefault)
+{
+    static_assert(std::is_same<opex::fault::site<gear::TestException>,
+                               opex::fault::inert::site<gear::TestException>>::value, "");
+    static const opex::fault::site<gear::TestException> site{"call.inert", "injected"};
+    opex::fault::set_rate(1.0);
+
+    const gear::TestResult result = opex::call<gear::TestException>(site, std::bind(gear::throw_if_true, false));
+    opex::fault::set_rate(0.0);
+
+    EXPECT_FALSE(opex::fault::enabled);
+    EXPECT_TRUE(result.is_ok());
+}
+#endif
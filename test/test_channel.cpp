@@ -0,0 +1,149 @@
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <opex/channel.h>
+
+#include "gear.h"
+
+namespace {
+    using channel_t = opex::result_channel<int, std::runtime_error>;
+    using result_t = channel_t::result_type;
+
+    result_t fail(const char *message) {
+        return result_t::make_exception<std::runtime_error>(message);
+    }
+}
+
+TEST(Channel, Fifo)
+{
+    channel_t channel{4};
+    EXPECT_TRUE(channel.try_push(result_t{1}));
+    EXPECT_TRUE(channel.try_push(fail("two")));
+    EXPECT_TRUE(channel.try_push(result_t{3}));
+
+    std::vector<std::string> seen;
+    while (channel.try_pop([&](result_t &&r) { seen.push_back(r ? std::to_string(*r) : r.what()); }))
+        ;
+
+    EXPECT_EQ((std::vector<std::string>{"1", "two", "3"}), seen);
+    EXPECT_FALSE(channel.finished());
+}
+
+TEST(Channel, Full)
+{
+    channel_t channel{2};
+    EXPECT_EQ(2u, channel.capacity());
+    EXPECT_TRUE(channel.try_push(result_t{1}));
+    EXPECT_TRUE(channel.try_push(result_t{2}));
+    EXPECT_FALSE(channel.try_push(result_t{3}));
+
+    EXPECT_TRUE(channel.try_pop([](result_t &&r) { EXPECT_EQ(1, r.unwrap()); }));
+    EXPECT_TRUE(channel.try_push(result_t{3}));
+}
+
+TEST(Channel, Batch)
+{
+    channel_t channel{8};
+    std::vector<result_t> input;
+    for (int i = 0; i < 12; ++i)
+        input.push_back(i % 3 ? result_t{i} : fail("third"));
+
+    const auto rest = channel.try_push_batch(input.begin(), input.end());
+    EXPECT_EQ(8, rest - input.begin());
+
+    std::vector<int> values;
+    std::size_t errors = 0;
+    const auto consume = [&](result_t &&r) {
+        if (r)
+            values.push_back(*r);
+        else
+            ++errors;
+    };
+    EXPECT_EQ(5u, channel.try_pop_batch(consume, 5));
+    EXPECT_EQ(4, channel.try_push_batch(rest, input.end()) - rest);
+    EXPECT_EQ(7u, channel.try_pop_batch(consume, 100));
+
+    EXPECT_EQ((std::vector<int>{1, 2, 4, 5, 7, 8, 10, 11}), values);
+    EXPECT_EQ(4u, errors);
+}
+
+TEST(Channel, Close)
+{
+    channel_t channel{4};
+    EXPECT_TRUE(channel.try_push(result_t{1}));
+    EXPECT_TRUE(channel.close(fail("upstream gone")));
+    EXPECT_FALSE(channel.close());
+    EXPECT_TRUE(channel.is_closed());
+    EXPECT_FALSE(channel.try_push(result_t{2}));
+
+    std::vector<std::string> seen;
+    while (channel.try_pop([&](result_t &&r) { seen.push_back(r ? std::to_string(*r) : r.what()); }))
+        ;
+
+    EXPECT_EQ((std::vector<std::string>{"1", "upstream gone"}), seen);
+    EXPECT_TRUE(channel.finished());
+}
+
+TEST(Channel, CloseDefault)
+{
+    channel_t channel{4};
+    channel.close();
+
+    EXPECT_TRUE(channel.try_pop([](result_t &&r) { EXPECT_THROW(r.unwrap(), opex::channel_closed); }));
+    EXPECT_FALSE(channel.try_pop([](result_t &&) { FAIL(); }));
+}
+
+TEST(Channel, NonTrivialValues)
+{
+    opex::result_channel<gear::TestType> channel{4};
+    const gear::TestType value;
+    EXPECT_TRUE(channel.try_push(opex::result<gear::TestType>{value}));
+    EXPECT_TRUE(channel.try_pop([&](opex::result<gear::TestType> &&r) { EXPECT_EQ(value, r.unwrap()); }));
+}
+
+TEST(Channel, MultipleProducers)
+{
+    const int producers = 4;
+    const int per_producer = 10000;
+    channel_t channel{64};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&channel, p] {
+            for (int i = 0; i < per_producer; ++i) {
+                while (!channel.try_push(i % 10 ? result_t{p * per_producer + i} : fail("tenth")))
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    std::vector<int> last(producers, -1);
+    long long sum = 0;
+    int errors = 0;
+    int received = 0;
+    while (received < producers * per_producer) {
+        const auto popped = channel.try_pop([&](result_t &&r) {
+            ++received;
+            if (!r) {
+                ++errors;
+                return;
+            }
+            const auto v = *r;
+            EXPECT_LT(last[v / per_producer], v % per_producer);
+            last[v / per_producer] = v % per_producer;
+            sum += v;
+        });
+        if (!popped)
+            std::this_thread::yield();
+    }
+    for (auto &t : threads)
+        t.join();
+
+    long long expected = 0;
+    for (int v = 0; v < producers * per_producer; ++v)
+        if (v % per_producer % 10)
+            expected += v;
+    EXPECT_EQ(expected, sum);
+    EXPECT_EQ(producers * per_producer / 10, errors);
+}
@@ -0,0 +1,84 @@
+#include <thread>
+
+#include <gtest/gtest.h>
+#include <opex/opex.h>
+
+#include "gear.h"
+
+namespace {
+    using result_type = opex::confined_result<int, std::runtime_error>;
+
+    result_type my_opex_enabled_function(bool fail) {
+        if (fail)
+            return result_type::make_exception<std::runtime_error>("fail!");
+        return result_type{1};
+    }
+}
+
+TEST(Confined, Call)
+{
+    const auto result = result_type::call([]() -> int { throw std::runtime_error{"call"}; });
+
+    EXPECT_TRUE(result.is_err());
+    EXPECT_EQ("call", result.what());
+    EXPECT_THROW(result.unwrap(), std::runtime_error);
+}
+
+TEST(Confined, ValidResult)
+{
+    const auto result1 = my_opex_enabled_function(false);
+    const auto result2 = result1.map([](int i) { return i + 1; });
+    const auto result3 = result2.and_then([](int i) { return result_type{i * 3}; });
+
+    EXPECT_EQ(6, result3.unwrap());
+}
+
+TEST(Confined, InvalidResult)
+{
+    const auto result1 = my_opex_enabled_function(true);
+    const auto result2 = result1.map([](int i) { return i + 1; });
+    const auto result3 = result2.and_then([](int i) { return result_type{i * 3}; });
+
+    EXPECT_EQ("fail!", result2.what());
+    EXPECT_EQ("fail!", result3.what());
+    EXPECT_THROW(result3.unwrap(), std::runtime_error);
+}
+
+TEST(Confined, OrElse)
+{
+    const auto result = my_opex_enabled_function(true).or_else([](const std::runtime_error &) {
+        return result_type{7};
+    });
+
+    EXPECT_EQ(7, result.unwrap());
+}
+
+TEST(Confined, MapErr)
+{
+    const auto result = my_opex_enabled_function(true).map_err([](const std::runtime_error &e) {
+        return gear::TestException{e.what()};
+    });
+
+    EXPECT_TRUE((std::is_same<opex::confined_error_handle, decltype(result)::error_handle>::value));
+    EXPECT_THROW(result.unwrap(), gear::TestException);
+}
+
+TEST(Confined, ContextDoesNotLeakIntoCopies)
+{
+    const auto result1 = my_opex_enabled_function(true);
+    const auto result2 = result1.map([](int i) { return i; });
+    const auto result3 = result2.context("outer");
+
+    EXPECT_EQ("fail!", result1.what());
+    EXPECT_EQ("fail!", result2.what());
+    EXPECT_EQ("outer: fail!", result3.what());
+}
+
+#ifndef NDEBUG
+TEST(ConfinedDeathTest, CrossThreadCopy)
+{
+    const auto result = my_opex_enabled_function(true);
+
+    EXPECT_DEATH(std::thread([&result] { result.map([](int i) { return i; }); }).join(), "confined");
+}
+#endif
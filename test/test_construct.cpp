@@ -1,4 +1,6 @@
 #include <functional>
+#include <string>
+#include <type_traits>
 
 #include <gtest/gtest.h>
 #include <opex/opex.h>
@@ -78,3 +80,42 @@ TEST(Construct, CallExcept)
     EXPECT_TRUE(result.is_err());
     EXPECT_THROW(result.unwrap(), gear::TestException);
 }
+
+TEST(Construct, WidenError)
+{
+    auto narrow = gear::TestResult::make_exception<gear::TestException>("WidenError");
+    const void *stored = narrow.err_visit([](const gear::TestException &e) { return static_cast<const void*>(&e); });
+
+    const opex::result<gear::TestType, std::exception> wide = std::move(narrow).context("widened");
+
+    EXPECT_TRUE(wide.is_err());
+    EXPECT_EQ("widened: WidenError", wide.what());
+    EXPECT_EQ(stored, wide.err_visit([](const std::exception &e) { return static_cast<const void*>(&e); }));
+}
+
+TEST(Construct, ConvertValue)
+{
+    opex::result<const char*, gear::TestException> source{"ConvertValue"};
+    const opex::result<std::string, std::runtime_error> converted = std::move(source);
+
+    EXPECT_EQ("ConvertValue", converted.unwrap());
+}
+
+TEST(Construct, ConvertCopy)
+{
+    const gear::TestType value;
+    const gear::TestResult ok{value};
+    const auto failed = gear::TestResult::make_exception<gear::TestException>("ConvertCopy");
+
+    const opex::result<gear::TestType, std::exception> ok_copy{ok};
+    const opex::result<gear::TestType, std::exception> failed_copy{failed};
+
+    EXPECT_EQ(value, ok_copy.unwrap());
+    EXPECT_TRUE(ok.unwrap().valid());
+    EXPECT_EQ("ConvertCopy", failed_copy.what());
+    EXPECT_EQ("ConvertCopy", failed.what());
+    static_assert(!std::is_convertible<const gear::TestResult&, opex::result<gear::TestType, std::exception>>::value,
+                  "converting copies are explicit");
+    static_assert(!std::is_constructible<gear::TestResult, opex::result<gear::TestType, std::exception>&&>::value,
+                  "errors only widen");
+}
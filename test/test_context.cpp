@@ -0,0 +1,145 @@
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <opex/context.h>
+#include <opex/opex.h>
+
+#include "gear.h"
+
+namespace {
+    using result_type = opex::result<int>;
+
+    result_type load(bool fail) {
+        if (fail)
+            return result_type::make_exception<std::runtime_error>("disk full");
+        return result_type{42};
+    }
+}
+
+TEST(Context, ValidResult)
+{
+    const auto result = load(false).context("while loading shard ", 17);
+
+    EXPECT_TRUE(result.is_ok());
+    EXPECT_EQ(42, result.unwrap());
+    EXPECT_EQ(std::string{}, result.what());
+}
+
+TEST(Context, InvalidResult)
+{
+    const auto result = load(true)
+            .context("while loading shard ", 17)
+            .context("user id ", 42);
+
+    EXPECT_TRUE(result.is_err());
+    EXPECT_EQ("user id 42: while loading shard 17: disk full", result.what());
+    EXPECT_EQ("disk full\n  while loading shard 17\n  user id 42", result.diagnostic());
+    EXPECT_THROW(result.unwrap(), std::runtime_error);
+}
+
+TEST(Context, ConstResult)
+{
+    const auto result1 = load(true).context("inner");
+    const auto result2 = result1.context("outer");
+
+    EXPECT_EQ("inner: disk full", result1.what());
+    EXPECT_EQ("outer: inner: disk full", result2.what());
+}
+
+TEST(Context, KeepsResultsSmall)
+{
+    static_assert(sizeof(result_type) == 2 * sizeof(void*), "context frames must not widen the default result");
+
+    const auto result = load(true);
+    const auto outer = result.context("outer");
+
+    EXPECT_EQ("disk full", result.what());
+    EXPECT_EQ("outer: disk full", outer.what());
+}
+
+TEST(Context, StoresArgumentsByValue)
+{
+    std::string shard{"shard-17"};
+    const auto result = load(true).context("while loading ", shard);
+    shard.clear();
+
+    EXPECT_EQ("while loading shard-17: disk full", result.what());
+}
+
+TEST(Context, CopiesCStrings)
+{
+    char buffer[32];
+    std::strcpy(buffer, "shard-17");
+    char *pointer = buffer;
+    const auto result = load(true).context(buffer, " ", pointer, " ", static_cast<const char*>(pointer));
+    std::memset(buffer, '?', sizeof(buffer) - 1);
+
+    EXPECT_EQ("shard-17 shard-17 shard-17: disk full", result.what());
+}
+
+TEST(Context, PropagatesThroughCombinators)
+{
+    const auto result1 = load(true).context("shard ", 3);
+
+    const auto mapped = result1.map([](int i) { return i + 1; });
+    EXPECT_EQ("shard 3: disk full", mapped.what());
+
+    const auto chained = result1.and_then([](int i) { return result_type{i}; });
+    EXPECT_EQ("shard 3: disk full", chained.what());
+
+    const auto converted = result1.map_err([](const std::exception &e) {
+        return gear::TestException{e.what()};
+    });
+    EXPECT_EQ("shard 3: disk full", converted.what());
+    EXPECT_THROW(converted.unwrap(), gear::TestException);
+}
+
+TEST(Context, OutlivesCreatingThread)
+{
+    std::unique_ptr<result_type> result;
+    std::thread([&result] {
+        result.reset(new result_type{load(true).context("worker ", 1)});
+    }).join();
+
+    EXPECT_EQ("worker 1: disk full", result->what());
+}
+
+TEST(Context, ManyFrames)
+{
+    std::vector<result_type> results;
+    results.reserve(10001);
+    results.push_back(load(true));
+    for (int i = 0; i < 10000; ++i)
+        results.push_back(std::move(results.back()).context(i));
+
+    const auto what = results.back().what();
+    EXPECT_EQ(0u, what.find("9999: 9998: "));
+    EXPECT_NE(std::string::npos, what.find("1: 0: disk full"));
+}
+
+namespace {
+    struct Shard {
+        int id;
+    };
+
+    std::ostream& operator<<(std::ostream &os, const Shard &shard) {
+        return os << "shard#" << shard.id;
+    }
+}
+
+TEST(Context, RendersArgumentsWithoutStreams)
+{
+    const auto result = load(true).context('[', 2.5, "] ", true, " ", std::string{"s"}, " ", -7, " ", 42u);
+    EXPECT_EQ("[2.5] 1 s -7 42: disk full", result.what());
+}
+
+TEST(Context, StreamsOtherTypes)
+{
+    const auto result = load(true).context("while loading ", Shard{17});
+    EXPECT_EQ("while loading shard#17: disk full", result.what());
+}
@@ -0,0 +1,90 @@
+#include <expected>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+#include <opex/expected.h>
+
+#include "gear.h"
+
+namespace {
+    using result_t = opex::result<int, gear::TestException>;
+    using expected_t = opex::expected<int, gear::TestException>;
+
+    const void* address_of_error(const result_t &r) {
+        return r.err_visit([](const gear::TestException &e) -> const void* { return &e; });
+    }
+}
+
+TEST(Expected, Types)
+{
+    static_assert(std::is_same_v<expected_t, decltype(opex::to_expected(std::declval<result_t>()))>);
+    static_assert(std::is_same_v<result_t, decltype(opex::from_expected(std::declval<expected_t>()))>);
+    static_assert(std::is_same_v<opex::result<int>,
+                                 decltype(opex::from_expected(std::declval<std::expected<int, std::out_of_range>>()))>);
+}
+
+TEST(Expected, ValueRoundTrip)
+{
+    auto e = opex::to_expected(result_t{7});
+    ASSERT_TRUE(e.has_value());
+    EXPECT_EQ(7, *e);
+
+    const auto r = opex::from_expected(std::move(e));
+    EXPECT_EQ(7, r.unwrap());
+}
+
+TEST(Expected, ErrorRoundTripKeepsTheException)
+{
+    auto original = result_t::make_exception<gear::TestException>("lost");
+    const auto address = address_of_error(original);
+
+    auto e = opex::to_expected(std::move(original).context("loading"));
+    ASSERT_FALSE(e.has_value());
+    EXPECT_EQ(address, e.error().visit([](const gear::TestException &ex) -> const void* { return &ex; }));
+
+    const auto r = opex::from_expected(std::move(e));
+    EXPECT_EQ(address, address_of_error(r));
+    EXPECT_NE(std::string::npos, r.diagnostic().find("loading"));
+    EXPECT_THROW(r.unwrap(), gear::TestException);
+}
+
+TEST(Expected, MovesValues)
+{
+    gear::CountedType::reset();
+    auto e = opex::to_expected(gear::CountedResult{gear::CountedType{1}});
+    const auto r = opex::from_expected(std::move(e));
+
+    EXPECT_EQ(0u, gear::CountedType::counts().copies);
+    EXPECT_LE(gear::CountedType::counts().moves, 3u);
+    EXPECT_EQ(1, r.unwrap().value());
+}
+
+#if __cpp_lib_expected >= 202211L
+TEST(Expected, MonadicOperations)
+{
+    const auto half = [](int v) -> expected_t {
+        if (v % 2)
+            return opex::to_expected(result_t::make_exception<gear::TestException>("odd"));
+        return v / 2;
+    };
+
+    EXPECT_EQ(3, opex::from_expected(opex::to_expected(result_t{12}).and_then(half).and_then(half)).unwrap());
+    EXPECT_EQ("odd", opex::from_expected(opex::to_expected(result_t{6}).and_then(half).and_then(half)).what());
+    EXPECT_EQ(5, opex::to_expected(result_t{4}).transform([](int v) { return v + 1; }).value());
+}
+#endif
+
+TEST(Expected, FromStdExpectedOfException)
+{
+    const std::expected<std::string, gear::TestException> failed{std::unexpect, "bad input"};
+    auto copy = failed;
+
+    const auto r = opex::from_expected<gear::TestException>(std::move(copy));
+    EXPECT_EQ("bad input", r.what());
+    EXPECT_THROW(r.unwrap(), gear::TestException);
+
+    const auto ok = opex::from_expected(std::expected<std::string, std::out_of_range>{"fine"});
+    EXPECT_EQ("fine", ok.unwrap());
+}
@@ -0,0 +1,193 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <opex/fault.h>
+
+#include "gear.h"
+
+namespace {
+    using result_t = opex::result<int, gear::TestException>;
+    using site_t = opex::fault::site<gear::TestException>;
+
+    // Restores the global defaults so tests do not leak rates into each other.
+    struct Defaults {
+        explicit Defaults(double rate) {
+            opex::fault::set_seed(42);
+            opex::fault::set_rate(rate);
+        }
+
+        ~Defaults() {
+            opex::fault::set_seed(0);
+            opex::fault::set_rate(0.0);
+        }
+    };
+
+    std::vector<bool> pattern(const site_t &site, int n) {
+        std::vector<bool> failed;
+        for (int i = 0; i < n; ++i)
+            failed.push_back(result_t::call(site, [] { return 1; }).is_err());
+        return failed;
+    }
+
+    int failures(const site_t &site, int n) {
+        int count = 0;
+        for (bool f : pattern(site, n))
+            count += f;
+        return count;
+    }
+}
+
+TEST(Fault, Enabled)
+{
+    static_assert(std::is_same<site_t, opex::fault::injected::site<gear::TestException>>::value,
+                  "sites built with injection must not share symbols with inert ones");
+    EXPECT_TRUE(opex::fault::enabled);
+}
+
+TEST(Fault, OffByDefault)
+{
+    const site_t site{"fault.off", "injected"};
+
+    EXPECT_EQ(0, failures(site, 1000));
+}
+
+TEST(Fault, FullRateSkipsTheFunction)
+{
+    Defaults defaults{1.0};
+    const site_t site{"fault.full", "injected"};
+    int calls = 0;
+
+    const auto r = result_t::call(site, [&calls] { return ++calls; });
+
+    EXPECT_EQ(0, calls);
+    EXPECT_EQ("injected", r.what());
+    EXPECT_THROW(r.unwrap(), gear::TestException);
+}
+
+TEST(Fault, Rates)
+{
+    const site_t site{"fault.rates", "injected"};
+
+    for (double rate : {0.1, 0.5, 0.9}) {
+        Defaults defaults{rate};
+        const auto n = failures(site, 10000);
+        EXPECT_NEAR(rate * 10000, n, 300) << "rate " << rate;
+    }
+}
+
+TEST(Fault, SeedReplaysTheSequence)
+{
+    Defaults defaults{0.5};
+    const site_t site{"fault.replay", "injected"};
+
+    const auto first = pattern(site, 256);
+    opex::fault::set_seed(42);
+    EXPECT_EQ(first, pattern(site, 256));
+
+    opex::fault::set_seed(43);
+    EXPECT_NE(first, pattern(site, 256));
+}
+
+TEST(Fault, TagsHaveTheirOwnSequence)
+{
+    Defaults defaults{0.5};
+    const site_t a{"fault.a", "injected"};
+    const site_t b{"fault.b", "injected"};
+    const site_t also_a{"fault.a", "injected"};
+
+    const auto from_a = pattern(a, 256);
+    opex::fault::set_seed(42);
+    EXPECT_NE(from_a, pattern(b, 256));
+
+    opex::fault::set_seed(42);
+    EXPECT_EQ(from_a, pattern(also_a, 256));
+}
+
+TEST(Fault, CollidingTagsKeepTheirSequences)
+{
+    // These two tags land in the same slot of a 64-entry table.
+    ASSERT_EQ(opex::_f::key_of("db.read") % 64, opex::_f::key_of("cache.get66") % 64);
+
+    Defaults defaults{0.5};
+    const site_t a{"db.read", "injected"};
+    const site_t b{"cache.get66", "injected"};
+
+    const auto alone_a = pattern(a, 256);
+    opex::fault::set_seed(42);
+    const auto alone_b = pattern(b, 256);
+
+    opex::fault::set_seed(42);
+    std::vector<bool> mixed_a, mixed_b;
+    for (int i = 0; i < 256; ++i) {
+        mixed_a.push_back(result_t::call(a, [] { return 1; }).is_err());
+        mixed_b.push_back(result_t::call(b, [] { return 1; }).is_err());
+    }
+
+    EXPECT_EQ(alone_a, mixed_a);
+    EXPECT_EQ(alone_b, mixed_b);
+}
+
+TEST(Fault, SequencesSurviveNewSites)
+{
+    Defaults defaults{0.5};
+    std::vector<std::string> tags;
+    for (int i = 0; i < 100; ++i)
+        tags.push_back("fault.many." + std::to_string(i));
+    std::vector<std::unique_ptr<site_t>> sites;
+    for (const auto &tag : tags)
+        sites.emplace_back(new site_t{tag.c_str(), "injected"});
+
+    const auto alone = pattern(*sites.front(), 200);
+
+    opex::fault::set_seed(42);
+    std::vector<bool> mixed;
+    for (int i = 0; i < 200; ++i) {
+        mixed.push_back(result_t::call(*sites.front(), [] { return 1; }).is_err());
+        pattern(*sites[1 + i % 99], 1);
+    }
+    EXPECT_EQ(alone, mixed);
+}
+
+TEST(Fault, SiteRateOverridesGlobal)
+{
+    Defaults defaults{1.0};
+    site_t site{"fault.override", "injected"};
+
+    site.set_rate(0.0);
+    EXPECT_EQ(0, failures(site, 100));
+
+    site.clear_rate();
+    EXPECT_EQ(100, failures(site, 100));
+}
+
+TEST(Fault, ThreadsReplayTheSameSequence)
+{
+    Defaults defaults{0.3};
+    const site_t site{"fault.threads", "injected"};
+
+    std::vector<std::vector<bool>> seen(4);
+    std::vector<std::thread> threads;
+    for (auto &s : seen)
+        threads.emplace_back([&site, &s] { s = pattern(site, 128); });
+    for (auto &t : threads)
+        t.join();
+
+    for (const auto &s : seen)
+        EXPECT_EQ(seen[0], s);
+}
+
+TEST(Fault, FreeCallInjectsDerivedException)
+{
+    Defaults defaults{1.0};
+    static const opex::fault::site<std::out_of_range> site{"fault.free", "dependency down"};
+
+    const auto r = opex::call(site, [] { return std::string{"unreachable"}; });
+
+    EXPECT_EQ("dependency down", r.what());
+    EXPECT_THROW(r.unwrap(), std::out_of_range);
+}
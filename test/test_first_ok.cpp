@@ -0,0 +1,58 @@
+#include <gtest/gtest.h>
+#include <opex/opex.h>
+
+#include "gear.h"
+
+namespace {
+    using result_t = opex::result<int, gear::TestException>;
+
+    struct Alternative {
+        int *calls;
+        bool fail;
+        int value;
+
+        result_t operator()() const {
+            ++*calls;
+            if (fail)
+                return result_t::make_exception<gear::TestException>("alternative failed");
+            return result_t{value};
+        }
+    };
+}
+
+TEST(FirstOk, Single)
+{
+    int calls = 0;
+    const auto result = opex::first_ok(Alternative{&calls, false, 1});
+
+    EXPECT_EQ(1, result.unwrap());
+    EXPECT_EQ(1, calls);
+}
+
+TEST(FirstOk, StopsAtFirstSuccess)
+{
+    int calls = 0;
+    const auto result = opex::first_ok(
+            Alternative{&calls, true, 1},
+            Alternative{&calls, false, 2},
+            Alternative{&calls, false, 3});
+
+    EXPECT_EQ(2, result.unwrap());
+    EXPECT_EQ(2, calls);
+}
+
+TEST(FirstOk, AllFail)
+{
+    int calls = 0;
+    const auto result = opex::first_ok(
+            Alternative{&calls, true, 1},
+            Alternative{&calls, true, 2},
+            [&calls]() -> result_t {
+                ++calls;
+                return result_t::make_exception<gear::TestException>("last");
+            });
+
+    EXPECT_TRUE(result.is_err());
+    EXPECT_EQ("last", result.what());
+    EXPECT_EQ(3, calls);
+}
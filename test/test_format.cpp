@@ -0,0 +1,82 @@
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <opex/format.h>
+
+#include "gear.h"
+
+TEST(Format, Placeholders)
+{
+    const opex::formatted_runtime_error error{"shard {} of {} failed for {} ({}, {})", 17, 32u, std::string{"user"}, 0.5, true};
+
+    EXPECT_STREQ("shard 17 of 32 failed for user (0.5, true)", error.what());
+}
+
+TEST(Format, Escapes)
+{
+    const opex::formatted_runtime_error error{"{{literal}} {}", 'x'};
+
+    EXPECT_STREQ("{literal} x", error.what());
+}
+
+TEST(Format, MissingArguments)
+{
+    const opex::formatted_runtime_error error{"{} and {}", -1};
+
+    EXPECT_STREQ("-1 and {}", error.what());
+}
+
+TEST(Format, CapturesByValue)
+{
+    std::string name{"shard-17"};
+    char buffer[] = "temporary";
+    const opex::formatted_runtime_error error{"{} {}", name, buffer};
+    name.clear();
+    buffer[0] = '\0';
+
+    EXPECT_STREQ("shard-17 temporary", error.what());
+}
+
+TEST(Format, Cached)
+{
+    const opex::formatted_runtime_error error{"value {}", 1};
+
+    EXPECT_EQ(error.what(), error.what());
+}
+
+TEST(Format, Truncated)
+{
+    const opex::formatted_error<std::runtime_error, 24> error{"{} {}", std::string(64, 'a'), 1};
+    const std::string what = error.what();
+
+    EXPECT_LT(what.size(), 64u);
+    EXPECT_EQ("...", what.substr(what.size() - 3));
+}
+
+TEST(Format, CatchAsBase)
+{
+    try {
+        throw opex::formatted_runtime_error{"code {}", 7};
+    } catch (const std::runtime_error &e) {
+        EXPECT_STREQ("code 7", e.what());
+    }
+}
+
+TEST(Format, MakeException)
+{
+    const auto result = opex::result<int, std::runtime_error>::make_exception<opex::formatted_runtime_error>("shard {} failed", 17);
+
+    EXPECT_TRUE(result.is_err());
+    EXPECT_EQ("shard 17 failed", result.what());
+    EXPECT_THROW(result.unwrap(), std::runtime_error);
+}
+
+TEST(Format, Copy)
+{
+    const opex::formatted_runtime_error error{"value {}", 3};
+    EXPECT_STREQ("value 3", error.what());
+
+    const auto copy = error;
+    EXPECT_STREQ("value 3", copy.what());
+}
@@ -0,0 +1,186 @@
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <opex/hedge.h>
+
+#include "gear.h"
+
+namespace {
+    using namespace std::chrono;
+
+    struct FakeBackend {
+        milliseconds latency;
+        bool fail;
+        int value;
+        std::shared_ptr<std::atomic<bool>> observed_cancel;
+
+        int operator()(const opex::cancel_token &token) const {
+            const auto deadline = steady_clock::now() + latency;
+            while (steady_clock::now() < deadline) {
+                if (token.is_cancelled()) {
+                    if (observed_cancel)
+                        *observed_cancel = true;
+                    throw std::runtime_error("cancelled");
+                }
+                std::this_thread::sleep_for(milliseconds(1));
+            }
+            if (fail)
+                throw gear::TestException("backend failed");
+            return value;
+        }
+    };
+}
+
+TEST(Hedge, FastPrimary)
+{
+    std::atomic<int> backup_calls{0};
+    const auto result = opex::hedge(
+            [] { return 1; },
+            [&backup_calls] { ++backup_calls; return 2; },
+            milliseconds(500));
+
+    EXPECT_EQ(1, result.unwrap());
+    EXPECT_EQ(0, backup_calls);
+}
+
+TEST(Hedge, SlowPrimaryIsCancelled)
+{
+    const auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    const auto start = steady_clock::now();
+    const auto result = opex::hedge(
+            FakeBackend{seconds(5), false, 1, cancelled},
+            FakeBackend{milliseconds(0), false, 2, nullptr},
+            milliseconds(10));
+
+    EXPECT_EQ(2, result.unwrap());
+    EXPECT_LT(steady_clock::now() - start, seconds(2));
+
+    for (int i = 0; i < 1000 && !*cancelled; ++i)
+        std::this_thread::sleep_for(milliseconds(1));
+    EXPECT_TRUE(*cancelled);
+}
+
+TEST(Hedge, FailingPrimaryStartsBackupEarly)
+{
+    const auto start = steady_clock::now();
+    const auto result = opex::hedge(
+            FakeBackend{milliseconds(0), true, 1, nullptr},
+            FakeBackend{milliseconds(0), false, 2, nullptr},
+            seconds(5));
+
+    EXPECT_EQ(2, result.unwrap());
+    EXPECT_LT(steady_clock::now() - start, seconds(2));
+}
+
+TEST(Hedge, BothFail)
+{
+    const auto result = opex::hedge(
+            FakeBackend{milliseconds(0), true, 1, nullptr},
+            FakeBackend{milliseconds(0), true, 2, nullptr},
+            milliseconds(10));
+
+    ASSERT_TRUE(result.is_err());
+    result.err_visit([](const opex::aggregate_error &errors) {
+        ASSERT_EQ(2u, errors.size());
+        EXPECT_EQ(2u, errors.count<gear::TestException>());
+        EXPECT_STREQ("backend failed", errors[0].what());
+        EXPECT_EQ(0u, errors[0].index());
+        EXPECT_EQ(1u, errors[1].index());
+    });
+}
+
+TEST(Hedge, OnlyCatchesExceptionType)
+{
+    const auto result = opex::hedge<gear::TestException>(
+            []() -> int { throw std::logic_error("not caught"); },
+            [] { return 2; },
+            milliseconds(10));
+
+    EXPECT_EQ(2, result.unwrap());
+}
+
+TEST(Hedge, RethrowsForeignExceptions)
+{
+    EXPECT_THROW(opex::hedge<gear::TestException>(
+            []() -> int { throw std::logic_error("not caught"); },
+            []() -> int { throw gear::TestException("caught"); },
+            milliseconds(10)), std::logic_error);
+}
+
+TEST(Hedge, RunsOnCallerExecutor)
+{
+    struct Counting : opex::executor {
+        opex::thread_pool pool{2};
+        std::atomic<int> posted{0};
+
+        void post(opex::_a::task &t) override {
+            ++posted;
+            pool.post(t);
+        }
+    };
+
+    const auto finished = std::make_shared<std::atomic<bool>>(false);
+    {
+        Counting ex;
+        const auto result = opex::hedge(
+                [finished](const opex::cancel_token &token) {
+                    while (!token.is_cancelled())
+                        std::this_thread::sleep_for(milliseconds(1));
+                    *finished = true;
+                    return 1;
+                },
+                [] { return 2; },
+                milliseconds(10), ex);
+
+        EXPECT_EQ(2, result.unwrap());
+        EXPECT_EQ(2, ex.posted);
+    }
+
+    // The pool joins its workers, so the losing attempt has finished by the time it is gone.
+    EXPECT_TRUE(*finished);
+}
+
+TEST(Hedge, SaturatedPoolQueuesAttempts)
+{
+    std::mutex mutex;
+    std::set<std::thread::id> workers;
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+
+    const auto attempt = [&](int value) {
+        return [&, value] {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                workers.insert(std::this_thread::get_id());
+            }
+            const auto now = ++running;
+            for (auto p = peak.load(); now > p && !peak.compare_exchange_weak(p, now);) {}
+            std::this_thread::sleep_for(milliseconds(20));
+            --running;
+            return value;
+        };
+    };
+
+    std::vector<int> values(4);
+    {
+        // Losing attempts may still be queued when the hedges return; the pool runs them before it goes away.
+        opex::_h::worker_pool pool{2};
+        std::vector<std::thread> callers;
+        for (int i = 0; i < 4; ++i)
+            callers.emplace_back([&, i] {
+                values[i] = opex::hedge(attempt(i), attempt(i), milliseconds(1), pool).unwrap();
+            });
+        for (auto &t : callers)
+            t.join();
+    }
+
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3}), values);
+    EXPECT_LE(peak.load(), 2);
+    EXPECT_LE(workers.size(), 2u);
+}
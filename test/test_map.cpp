@@ -1,10 +1,19 @@
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
 #include <gtest/gtest.h>
 #include <opex/opex.h>
 
 #include "gear.h"
 
 namespace {
-    using result_type = opex::result<int>;
+#ifdef OPEX_TEST_VALUE_BACKEND
+    // The value backend stores its error as declared, so it declares the type it fails with.
+    using result_type = gear::backend_result<int, std::runtime_error>;
+#else
+    using result_type = gear::backend_result<int>;
+#endif
 
     result_type my_opex_enabled_function(bool fail) {
         if (fail)
@@ -86,3 +95,29 @@ TEST(Map, InvalidRvalueResult)
     });
     EXPECT_TRUE(result2.is_err());
 }
+
+#ifndef OPEX_TEST_VALUE_BACKEND
+TEST(Map, ResultTraits)
+{
+    using to_string = std::string (*)(const int &);
+    using to_error = std::logic_error (*)(const std::exception &);
+    using chain = result_type (*)(int);
+
+    static_assert(std::is_same<opex::result<std::string>, result_type::rebind_value_t<to_string, const int &>>::value, "");
+    static_assert(std::is_same<opex::result<int, std::logic_error>,
+                               result_type::rebind_error_t<to_error, const std::exception &>>::value, "");
+
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+#endif
+    static_assert(std::is_same<result_type::rebind_value_t<to_string, const int &>,
+                               result_type::rebind_t<to_string(const int &)>>::value, "");
+    static_assert(std::is_same<result_type::rebind_error_t<to_error, const std::exception &>,
+                               result_type::rebind_err_t<to_error(const std::exception &)>>::value, "");
+    static_assert(std::is_same<result_type, result_type::compatible_result_of_t<chain(int)>>::value, "");
+#if defined(__GNUC__) || defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+}
+#endif
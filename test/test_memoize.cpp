@@ -0,0 +1,169 @@
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <opex/memoize.h>
+
+#include "gear.h"
+
+namespace {
+    struct FakeClock {
+        using duration = std::chrono::milliseconds;
+        using rep = duration::rep;
+        using period = duration::period;
+        using time_point = std::chrono::time_point<FakeClock>;
+        static constexpr bool is_steady = true;
+
+        static time_point now() noexcept { return time_point{s_now}; }
+
+        static duration s_now;
+    };
+
+    FakeClock::duration FakeClock::s_now{0};
+
+    using cache_t = opex::memoize<std::string, int, gear::TestException, std::hash<std::string>, FakeClock>;
+    using result_t = cache_t::result_type;
+
+    const auto value_ttl = std::chrono::milliseconds(1000);
+    const auto error_ttl = std::chrono::milliseconds(100);
+
+    struct Lookup {
+        std::atomic<int> *calls;
+
+        int operator()(const std::string &key) const {
+            ++*calls;
+            if (key.empty())
+                throw gear::TestException("empty key");
+            return static_cast<int>(key.size());
+        }
+    };
+}
+
+TEST(Memoize, SharesCachedValues)
+{
+    cache_t cache{value_ttl, error_ttl};
+    std::atomic<int> calls{0};
+
+    const auto first = cache.get("abc", Lookup{&calls});
+    const auto second = cache.get("abc", Lookup{&calls});
+
+    EXPECT_EQ(3, first->unwrap());
+    EXPECT_EQ(first.get(), second.get());
+    EXPECT_EQ(1, calls);
+}
+
+TEST(Memoize, ValuesExpire)
+{
+    cache_t cache{value_ttl, error_ttl};
+    std::atomic<int> calls{0};
+
+    cache.get("abc", Lookup{&calls});
+    FakeClock::s_now += value_ttl - std::chrono::milliseconds(1);
+    cache.get("abc", Lookup{&calls});
+    EXPECT_EQ(1, calls);
+
+    FakeClock::s_now += std::chrono::milliseconds(1);
+    EXPECT_EQ(nullptr, cache.peek("abc"));
+    cache.get("abc", Lookup{&calls});
+    EXPECT_EQ(2, calls);
+}
+
+TEST(Memoize, ErrorsHaveTheirOwnTtl)
+{
+    cache_t cache{value_ttl, error_ttl};
+    std::atomic<int> calls{0};
+
+    const auto failed = cache.get("", Lookup{&calls});
+    EXPECT_EQ("empty key", failed->what());
+
+    FakeClock::s_now += error_ttl / 2;
+    EXPECT_EQ(failed.get(), cache.get("", Lookup{&calls}).get());
+    EXPECT_EQ(1, calls);
+
+    FakeClock::s_now += error_ttl;
+    cache.get("", Lookup{&calls});
+    EXPECT_EQ(2, calls);
+}
+
+TEST(Memoize, ZeroTtlDisablesNegativeCaching)
+{
+    cache_t cache{value_ttl, FakeClock::duration::zero()};
+    std::atomic<int> calls{0};
+
+    cache.get("", Lookup{&calls});
+    cache.get("", Lookup{&calls});
+    cache.get("ok", Lookup{&calls});
+    cache.get("ok", Lookup{&calls});
+
+    EXPECT_EQ(3, calls);
+    EXPECT_EQ(1u, cache.size());
+}
+
+TEST(Memoize, FuncReturningResult)
+{
+    cache_t cache{value_ttl, error_ttl};
+
+    const auto r = cache.get("x", [](const std::string &) {
+        return result_t::make_exception<gear::TestException>("from result");
+    });
+
+    EXPECT_EQ("from result", r->what());
+}
+
+TEST(Memoize, CoalescesConcurrentMisses)
+{
+    cache_t cache{value_ttl, error_ttl, 4};
+    std::atomic<int> calls{0};
+    const auto slow = [&calls](const std::string &key) {
+        ++calls;
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        return static_cast<int>(key.size());
+    };
+
+    std::vector<std::thread> threads;
+    std::vector<cache_t::handle> seen(8);
+    for (std::size_t i = 0; i < seen.size(); ++i)
+        threads.emplace_back([&, i] { seen[i] = cache.get("shared", slow); });
+    for (auto &t : threads)
+        t.join();
+
+    EXPECT_EQ(1, calls);
+    for (const auto &h : seen)
+        EXPECT_EQ(seen[0].get(), h.get());
+}
+
+TEST(Memoize, ThrowingFuncIsNotCached)
+{
+    cache_t cache{value_ttl, error_ttl};
+    std::atomic<int> calls{0};
+
+    EXPECT_THROW(cache.get("k", [&](const std::string &) -> int { ++calls; throw std::logic_error("escaped"); }),
+                 std::logic_error);
+    EXPECT_EQ(0u, cache.size());
+    EXPECT_EQ(1, cache.get("k", Lookup{&calls})->unwrap());
+    EXPECT_EQ(2, calls);
+}
+
+TEST(Memoize, InvalidateAndPurge)
+{
+    cache_t cache{value_ttl, error_ttl};
+    std::atomic<int> calls{0};
+
+    cache.get("a", Lookup{&calls});
+    cache.get("bb", Lookup{&calls});
+    cache.get("", Lookup{&calls});
+    EXPECT_EQ(3u, cache.size());
+
+    cache.invalidate("a");
+    EXPECT_EQ(nullptr, cache.peek("a"));
+    EXPECT_EQ(2u, cache.size());
+
+    FakeClock::s_now += error_ttl;
+    cache.purge();
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_EQ(2, cache.peek("bb")->unwrap());
+}
@@ -0,0 +1,262 @@
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+
+#include <gtest/gtest.h>
+#include <opex/opex.h>
+#include <opex/zip.h>
+
+#include "gear.h"
+
+// Upper bounds on value copies and moves per combinator. Counts are read while the result is still alive, so
+// destructs only cover temporaries left behind on the way. A regression here usually means an extra
+// intermediate slipped into a hot path.
+
+namespace {
+    using gear::CountedType;
+    using gear::CountedResult;
+
+    ::testing::AssertionResult at_most(unsigned copies, unsigned moves, unsigned destructs) {
+        const auto &c = CountedType::counts();
+        if (c.copies <= copies && c.moves <= moves && c.destructs <= destructs && !c.copy_assigns && !c.move_assigns)
+            return ::testing::AssertionSuccess();
+        return ::testing::AssertionFailure()
+                << "copies " << c.copies << " (max " << copies << "), "
+                << "moves " << c.moves << " (max " << moves << "), "
+                << "destructs " << c.destructs << " (max " << destructs << "), "
+                << "assigns " << c.copy_assigns + c.move_assigns << " (max 0)";
+    }
+
+    CountedResult ok(int value) {
+        return CountedResult{CountedType{value}};
+    }
+
+    CountedResult fail() {
+        return CountedResult::make_exception<gear::TestException>("fail");
+    }
+
+    CountedType inc(const CountedType &v) {
+        return CountedType{v.value() + 1};
+    }
+
+    CountedResult next(const CountedType &v) {
+        return ok(v.value() + 1);
+    }
+
+    CountedResult recover(const gear::TestException &) {
+        return ok(0);
+    }
+
+    std::logic_error rethrow_as(const gear::TestException &e) {
+        return std::logic_error(e.what());
+    }
+}
+
+TEST(Moves, Construct)
+{
+    CountedType v{1};
+
+    CountedType::reset();
+    const CountedResult copied{v};
+    EXPECT_TRUE(at_most(1, 0, 0));
+
+    CountedType::reset();
+    const CountedResult moved{std::move(v)};
+    EXPECT_TRUE(at_most(0, 1, 0));
+
+    auto source = ok(1);
+    CountedType::reset();
+    const CountedResult relocated{std::move(source)};
+    EXPECT_TRUE(at_most(0, 1, 0));
+
+    auto narrow = ok(1);
+    CountedType::reset();
+    const opex::result<CountedType> widened{std::move(narrow)};
+    EXPECT_TRUE(at_most(0, 1, 0));
+}
+
+TEST(Moves, Call)
+{
+    CountedType::reset();
+    const auto r = CountedResult::call([] { return CountedType{3}; });
+    EXPECT_TRUE(at_most(0, 0, 0));
+}
+
+TEST(Moves, Map)
+{
+    const auto source = ok(1);
+    auto lvalue = ok(1);
+    auto rvalue = ok(1);
+
+    CountedType::reset();
+    const auto from_const = source.map(inc);
+    EXPECT_TRUE(at_most(0, 0, 0));
+
+    CountedType::reset();
+    const auto from_lvalue = lvalue.map(inc);
+    EXPECT_TRUE(at_most(0, 0, 0));
+
+    CountedType::reset();
+    const auto from_rvalue = std::move(rvalue).map([](CountedType &&v) { return CountedType{v.value() + 1}; });
+    EXPECT_TRUE(at_most(0, 0, 0));
+
+    auto passthrough = ok(1);
+    CountedType::reset();
+    const auto forwarded = std::move(passthrough).map([](CountedType &&v) { return std::move(v); });
+    EXPECT_TRUE(at_most(0, 1, 0));
+}
+
+TEST(Moves, MapErr)
+{
+    const auto source = ok(1);
+    auto lvalue = ok(1);
+    auto rvalue = ok(1);
+
+    CountedType::reset();
+    const auto from_const = source.map_err(rethrow_as);
+    EXPECT_TRUE(at_most(1, 0, 0));
+
+    CountedType::reset();
+    const auto from_lvalue = lvalue.map_err(rethrow_as);
+    EXPECT_TRUE(at_most(1, 0, 0));
+
+    CountedType::reset();
+    const auto from_rvalue = std::move(rvalue).map_err(rethrow_as);
+    EXPECT_TRUE(at_most(0, 1, 0));
+}
+
+TEST(Moves, AndThen)
+{
+    const auto source = ok(1);
+    auto lvalue = ok(1);
+    auto rvalue = ok(1);
+
+    CountedType::reset();
+    const auto from_const = source.and_then(next);
+    EXPECT_TRUE(at_most(0, 1, 1));
+
+    CountedType::reset();
+    const auto from_lvalue = lvalue.and_then(next);
+    EXPECT_TRUE(at_most(0, 1, 1));
+
+    CountedType::reset();
+    const auto from_rvalue = std::move(rvalue).and_then([](CountedType &&v) { return CountedResult{std::move(v)}; });
+    EXPECT_TRUE(at_most(0, 1, 0));
+}
+
+TEST(Moves, OrElse)
+{
+    const auto source = ok(1);
+    auto lvalue = ok(1);
+    auto rvalue = ok(1);
+
+    CountedType::reset();
+    const auto from_const = source.or_else(recover);
+    EXPECT_TRUE(at_most(1, 0, 0));
+
+    CountedType::reset();
+    const auto from_lvalue = lvalue.or_else(recover);
+    EXPECT_TRUE(at_most(1, 0, 0));
+
+    CountedType::reset();
+    const auto from_rvalue = std::move(rvalue).or_else([](gear::TestException &&) { return ok(0); });
+    EXPECT_TRUE(at_most(0, 1, 0));
+}
+
+TEST(Moves, Select)
+{
+    const auto left = ok(1);
+    const auto right = ok(2);
+
+    CountedType::reset();
+    const auto &selected = left.and_select(right);
+    EXPECT_EQ(&right, &selected);
+    EXPECT_TRUE(at_most(0, 0, 0));
+
+    auto a = ok(1);
+    auto b = ok(2);
+    CountedType::reset();
+    const auto and_selected = std::move(a).and_select(std::move(b));
+    EXPECT_TRUE(at_most(0, 1, 0));
+
+    auto c = ok(1);
+    auto d = ok(2);
+    CountedType::reset();
+    const auto or_selected = std::move(c).or_select(std::move(d));
+    EXPECT_TRUE(at_most(0, 1, 0));
+
+    auto e = ok(1);
+    CountedType::reset();
+    const auto with = std::move(e).and_select_with([] { return ok(2); });
+    EXPECT_TRUE(at_most(0, 1, 1));
+
+    auto f = ok(1);
+    CountedType::reset();
+    const auto or_with = std::move(f).or_select_with([] { return ok(2); });
+    EXPECT_TRUE(at_most(0, 1, 0));
+}
+
+TEST(Moves, UnwrapAndContext)
+{
+    auto source = ok(1);
+    CountedType::reset();
+    const CountedType value{std::move(source).unwrap()};
+    EXPECT_TRUE(at_most(0, 1, 0));
+
+    auto annotated = ok(1);
+    CountedType::reset();
+    const auto with_context = std::move(annotated).context("step");
+    EXPECT_TRUE(at_most(0, 1, 0));
+
+    const auto shared = ok(1);
+    CountedType::reset();
+    const auto copied_context = shared.context("step");
+    EXPECT_TRUE(at_most(1, 0, 0));
+}
+
+TEST(Moves, ZipAndApply)
+{
+    auto a = ok(1);
+    auto b = ok(2);
+    CountedType::reset();
+    const auto zipped = opex::zip(std::move(a), std::move(b));
+    EXPECT_TRUE(at_most(0, 2, 0));
+
+    auto c = ok(1);
+    auto d = ok(2);
+    CountedType::reset();
+    const auto applied = opex::apply([](CountedType &&x, CountedType &&y) {
+        return CountedType{x.value() + y.value()};
+    }, std::move(c), std::move(d));
+    EXPECT_TRUE(at_most(0, 0, 0));
+    EXPECT_EQ(3, applied.unwrap().value());
+}
+
+TEST(Moves, Chain)
+{
+    auto source = ok(1);
+    CountedType::reset();
+    const auto r = std::move(source)
+            .map([](CountedType &&v) { return CountedType{v.value() + 1}; })
+            .map([](CountedType &&v) { return CountedType{v.value() * 2}; })
+            .and_then([](CountedType &&v) { return CountedResult{std::move(v)}; });
+    EXPECT_TRUE(at_most(0, 1, 2));
+    EXPECT_EQ(4, r.unwrap().value());
+}
+
+TEST(Moves, ErrorsLeaveValuesAlone)
+{
+    const auto source = fail();
+    auto partner = ok(1);
+    CountedType::reset();
+
+    const auto mapped = source.map(inc);
+    const auto chained = source.and_then(next);
+    const auto converted = source.map_err(rethrow_as);
+    const auto annotated = source.context("step");
+    const auto widened = opex::result<CountedType>{fail()};
+    const auto zipped = opex::zip(fail(), std::move(partner));
+
+    EXPECT_TRUE(zipped.is_err());
+    EXPECT_TRUE(at_most(0, 0, 0));
+}
@@ -0,0 +1,144 @@
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+#include <opex/opex.h>
+
+#ifndef OPEX_NO_EXCEPTIONS
+#error "test_no_exceptions must be built with exceptions disabled"
+#endif
+
+namespace {
+    using result_type = opex::result<int, std::runtime_error>;
+
+    struct tagged {
+        virtual ~tagged() = default;
+        int tag = 7;
+    };
+
+    class tagged_error : public tagged, public std::runtime_error {
+    public:
+        explicit tagged_error(const char *message): std::runtime_error(message) {}
+    };
+
+    result_type parse(const std::string &s) {
+        if (s.empty())
+            return result_type::make_exception<std::range_error>("empty input");
+        return result_type{static_cast<int>(s.size())};
+    }
+
+    void custom_handler(const char *message) {
+        std::fprintf(stderr, "custom handler: %s\n", message);
+    }
+}
+
+TEST(NoExceptions, Call)
+{
+    const auto result = result_type::call([] { return 3; });
+
+    EXPECT_TRUE(result.is_ok());
+    EXPECT_EQ(3, result.unwrap());
+}
+
+TEST(NoExceptions, ValidResult)
+{
+    const auto result = parse("abc")
+            .map([](int i) { return i + 1; })
+            .and_then([](int i) { return result_type{i * 3}; });
+
+    EXPECT_TRUE(result.is_ok());
+    EXPECT_EQ(12, result.unwrap());
+    EXPECT_EQ(std::string{}, result.what());
+}
+
+TEST(NoExceptions, InvalidResult)
+{
+    const auto result = parse("")
+            .map([](int i) { return i + 1; })
+            .and_then([](int i) { return result_type{i * 3}; });
+
+    EXPECT_TRUE(result.is_err());
+    EXPECT_EQ("empty input", result.what());
+    EXPECT_TRUE(result.err_visit([](const std::runtime_error &e) {
+        return dynamic_cast<const std::range_error*>(&e) != nullptr;
+    }));
+}
+
+TEST(NoExceptions, MapErr)
+{
+    const auto result = parse("").map_err([](const std::runtime_error &e) {
+        return std::logic_error(std::string{"wrapped: "} + e.what());
+    });
+
+    EXPECT_TRUE(result.is_err());
+    EXPECT_EQ("wrapped: empty input", result.what());
+}
+
+TEST(NoExceptions, OrElse)
+{
+    const auto result = parse("").or_else([](const std::runtime_error &) { return result_type{-1}; });
+
+    EXPECT_EQ(-1, result.unwrap());
+}
+
+TEST(NoExceptions, Context)
+{
+    const auto result = parse("").context("while parsing line ", 4);
+
+    EXPECT_EQ("while parsing line 4: empty input", result.what());
+    EXPECT_EQ("empty input\n  while parsing line 4", result.diagnostic());
+}
+
+TEST(NoExceptions, WidenToBase)
+{
+    using tagged_result = opex::result<int, tagged_error>;
+
+    const auto source = tagged_result::make_exception<tagged_error>("tagged");
+    EXPECT_EQ(7, source.err_visit([](const tagged_error &e) { return e.tag; }));
+
+    const auto widened = source.and_then([](int i) { return result_type{i}; });
+    EXPECT_EQ("tagged", widened.what());
+    EXPECT_EQ(std::string{"tagged"}, widened.err_visit([](const std::runtime_error &e) { return e.what(); }));
+
+    const auto confined = opex::confined_result<int, tagged_error>::make_exception<tagged_error>("confined")
+            .and_then([](int i) { return opex::confined_result<int, std::runtime_error>{i}; });
+    EXPECT_EQ("confined", confined.what());
+}
+
+TEST(NoExceptions, WidenByConversion)
+{
+    auto source = opex::result<int, tagged_error>::make_exception<tagged_error>("converted");
+    const result_type widened = std::move(source);
+
+    EXPECT_EQ("converted", widened.what());
+    EXPECT_EQ(std::string{"converted"}, widened.err_visit([](const std::runtime_error &e) { return e.what(); }));
+}
+
+TEST(NoExceptions, TerminateHandler)
+{
+    EXPECT_EQ(nullptr, opex::get_terminate_handler());
+    EXPECT_EQ(nullptr, opex::set_terminate_handler(custom_handler));
+    EXPECT_EQ(&custom_handler, opex::get_terminate_handler());
+    EXPECT_EQ(&custom_handler, opex::set_terminate_handler(nullptr));
+}
+
+TEST(NoExceptionsDeathTest, UnwrapError)
+{
+    const auto result = parse("").context("reading config");
+
+    EXPECT_DEATH(result.unwrap(), "opex: reading config: empty input");
+    EXPECT_DEATH({
+        opex::set_terminate_handler(custom_handler);
+        result.unwrap();
+    }, "custom handler: reading config: empty input");
+}
+
+TEST(NoExceptionsDeathTest, ErrVisitValue)
+{
+    const auto result = parse("abc");
+
+    EXPECT_DEATH(result.err_visit([](const std::runtime_error &) { return 0; }),
+                 "err_visit can only be called on error'd instances");
+}
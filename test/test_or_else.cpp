@@ -4,7 +4,7 @@
 #include "gear.h"
 
 namespace {
-    using result_type = opex::result<gear::TestType, gear::TestException>;
+    using result_type = gear::TestResult;
 
     result_type my_opex_enabled_function(bool fail) {
         if (fail)
@@ -24,7 +24,7 @@ namespace {
         }
     };
 
-    using other_result_type = opex::result<gear::TestType, OtherException>;
+    using other_result_type = gear::backend_result<gear::TestType, OtherException>;
 }
 
 TEST(OrElse, ValidResult)
@@ -88,3 +88,33 @@ TEST(OrSelect, RValueErr)
     EXPECT_EQ(expected, make_exception().or_select(rhs_clvalue).unwrap());
     EXPECT_EQ(expected, make_exception().or_select(result_t{gear::TestType{expected}}).unwrap());
 }
+
+TEST(OrSelectWith, Value)
+{
+    const gear::TestType expected{};
+    result_t lhs{expected};
+    const result_t clhs{expected};
+
+    int calls = 0;
+    const auto alternative = [&] { ++calls; return result_t{gear::TestType{}}; };
+
+    EXPECT_EQ(expected, lhs.or_select_with(alternative).unwrap());
+    EXPECT_EQ(expected, clhs.or_select_with(alternative).unwrap());
+    EXPECT_EQ(expected, result_t{gear::TestType{expected}}.or_select_with(alternative).unwrap());
+    EXPECT_EQ(0, calls);
+}
+
+TEST(OrSelectWith, Err)
+{
+    const gear::TestType expected{};
+    result_t lhs = make_exception();
+    const result_t clhs = make_exception();
+
+    int calls = 0;
+    const auto alternative = [&] { ++calls; return result_t{expected}; };
+
+    EXPECT_EQ(expected, lhs.or_select_with(alternative).unwrap());
+    EXPECT_EQ(expected, clhs.or_select_with(alternative).unwrap());
+    EXPECT_EQ(expected, make_exception().or_select_with(alternative).unwrap());
+    EXPECT_EQ(3, calls);
+}
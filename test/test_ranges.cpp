@@ -0,0 +1,140 @@
+#include <ranges>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <opex/ranges.h>
+
+#include "gear.h"
+
+namespace {
+    using result_t = opex::result<int, gear::TestException>;
+
+    result_t parse(int i) {
+        if (i < 0)
+            return result_t::make_exception<gear::TestException>("negative");
+        return result_t{i};
+    }
+
+    std::vector<result_t> sample() {
+        std::vector<result_t> v;
+        for (int i : {1, 2, -3, 4, -5, 6})
+            v.push_back(parse(i));
+        return v;
+    }
+
+    template<typename Range>
+    std::vector<int> unwrap_all(Range &&range) {
+        std::vector<int> out;
+        for (auto &&r : range)
+            out.push_back(r.is_ok() ? r.unwrap() : -1);
+        return out;
+    }
+}
+
+TEST(Ranges, MapOk)
+{
+    const auto input = sample();
+    auto view = input | opex::views::map_ok([](int i) { return i * 10; });
+
+    EXPECT_EQ(std::vector<int>({10, 20, -1, 40, -1, 60}), unwrap_all(view));
+}
+
+TEST(Ranges, AndThen)
+{
+    const auto input = sample();
+    auto view = input | opex::views::and_then([](int i) {
+        return i % 2 ? result_t::make_exception<gear::TestException>("odd") : result_t{i};
+    });
+
+    EXPECT_EQ(std::vector<int>({-1, 2, -1, 4, -1, 6}), unwrap_all(view));
+}
+
+TEST(Ranges, FilterOkAndErrors)
+{
+    const auto input = sample();
+
+    EXPECT_EQ(std::vector<int>({1, 2, 4, 6}), unwrap_all(input | opex::views::filter_ok));
+
+    std::vector<std::string> messages;
+    for (const auto &r : input | opex::views::errors)
+        messages.push_back(r.what());
+    EXPECT_EQ(std::vector<std::string>({"negative", "negative"}), messages);
+}
+
+TEST(Ranges, TakeWhileOk)
+{
+    const auto input = sample();
+
+    EXPECT_EQ(std::vector<int>({1, 2}), unwrap_all(input | opex::views::take_while_ok));
+}
+
+TEST(Ranges, ValuesOrStopReferencesStoredValues)
+{
+    const std::vector<result_t> input = [] {
+        std::vector<result_t> v;
+        v.emplace_back(1);
+        v.emplace_back(2);
+        return v;
+    }();
+
+    auto view = input | opex::views::values_or_stop;
+    static_assert(std::is_same_v<const int&, std::ranges::range_reference_t<decltype(view)>>);
+    EXPECT_EQ(&input[0].unwrap(), &*view.begin());
+}
+
+TEST(Ranges, ComposesOverInputStreams)
+{
+    std::istringstream in{"1 2 3 -4 5"};
+    auto pipeline = std::views::istream<int>(in)
+            | std::views::transform(parse)
+            | opex::views::map_ok([](int i) { return std::to_string(i * i); })
+            | opex::views::values_or_stop;
+
+    std::vector<std::string> out;
+    for (auto &&s : pipeline)
+        out.push_back(std::move(s));
+
+    EXPECT_EQ(std::vector<std::string>({"1", "4", "9"}), out);
+}
+
+TEST(Ranges, Lazy)
+{
+    int calls = 0;
+    auto view = std::views::iota(0)
+            | std::views::transform([&calls](int i) { ++calls; return parse(i < 3 ? i : -i); })
+            | opex::views::take_while_ok;
+
+    EXPECT_EQ(0, calls);
+    int n = 0;
+    for (const auto &r : view)
+        n += r.unwrap();
+    EXPECT_EQ(3, n);
+    EXPECT_EQ(4, calls);
+}
+
+TEST(Ranges, EvaluatesEachElementOnce)
+{
+    const auto input = sample();
+    int calls = 0;
+    const auto times_ten = opex::views::map_ok([&calls](int i) { ++calls; return i * 10; });
+
+    EXPECT_EQ(std::vector<int>({10, 20, 40, 60}), unwrap_all(input | times_ten | opex::views::filter_ok));
+    EXPECT_EQ(4, calls);
+
+    calls = 0;
+    EXPECT_EQ(2, std::ranges::distance(input | times_ten | opex::views::errors));
+    EXPECT_EQ(4, calls);
+
+    calls = 0;
+    EXPECT_EQ(std::vector<int>({10, 20}), unwrap_all(input | times_ten | opex::views::take_while_ok));
+    EXPECT_EQ(2, calls);
+
+    calls = 0;
+    std::vector<int> values;
+    for (int v : input | (times_ten | opex::views::values_or_stop))
+        values.push_back(v);
+    EXPECT_EQ(std::vector<int>({10, 20}), values);
+    EXPECT_EQ(2, calls);
+}
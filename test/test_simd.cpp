@@ -0,0 +1,158 @@
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <opex/simd.h>
+
+#include "gear.h"
+
+namespace {
+    const opex::simd::isa all_isas[] = {
+        opex::simd::isa::scalar, opex::simd::isa::sse2, opex::simd::isa::avx2, opex::simd::isa::avx512
+    };
+
+    template<typename T>
+    std::vector<opex::result<T>> make_results(std::size_t n, const std::vector<std::size_t> &errors) {
+        std::vector<opex::result<T>> results;
+        results.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            bool error = false;
+            for (auto e : errors)
+                error = error || e == i;
+            if (error)
+                results.push_back(opex::result<T>::template make_exception<std::runtime_error>("bad field"));
+            else
+                results.push_back(opex::result<T>{static_cast<T>(i + 1)});
+        }
+        return results;
+    }
+
+    class restore_isa {
+    public:
+        restore_isa(): m_isa(opex::simd::active()) {}
+        ~restore_isa() { opex::simd::use(m_isa); }
+
+    private:
+        opex::simd::isa m_isa;
+    };
+}
+
+TEST(Simd, Dispatch)
+{
+    restore_isa restore;
+
+    EXPECT_TRUE(opex::simd::supported(opex::simd::isa::scalar));
+    EXPECT_TRUE(opex::simd::supported(opex::simd::best()));
+    EXPECT_TRUE(opex::simd::use(opex::simd::isa::scalar));
+    EXPECT_EQ(opex::simd::isa::scalar, opex::simd::active());
+    for (auto isa : all_isas)
+        EXPECT_EQ(opex::simd::supported(isa), opex::simd::use(isa));
+}
+
+TEST(Simd, Empty)
+{
+    const opex::result<double> *none = nullptr;
+
+    EXPECT_EQ(0u, opex::simd::count_ok(none, 0));
+    EXPECT_TRUE(opex::simd::all_ok(none, 0));
+    EXPECT_EQ(0u, opex::simd::first_error_index(none, 0));
+    EXPECT_EQ(0.0, opex::simd::sum_ok(none, 0));
+}
+
+TEST(Simd, MaskOperations)
+{
+    restore_isa restore;
+    const std::vector<std::size_t> errors = {0, 5, 63, 64, 100, 199};
+
+    for (auto isa : all_isas) {
+        if (!opex::simd::use(isa))
+            continue;
+
+        for (std::size_t n : {1, 3, 16, 63, 64, 65, 130, 200}) {
+            const auto clean = make_results<double>(n, {});
+            EXPECT_EQ(n, opex::simd::count_ok(clean.data(), n));
+            EXPECT_TRUE(opex::simd::all_ok(clean.data(), n));
+            EXPECT_EQ(n, opex::simd::first_error_index(clean.data(), n));
+
+            const auto dirty = make_results<double>(n, errors);
+            std::size_t expected_ok = 0, expected_first = n;
+            for (std::size_t i = 0; i < n; ++i) {
+                if (dirty[i].is_ok())
+                    ++expected_ok;
+                else if (expected_first == n)
+                    expected_first = i;
+            }
+            EXPECT_EQ(expected_ok, opex::simd::count_ok(dirty.data(), n)) << "n = " << n;
+            EXPECT_FALSE(opex::simd::all_ok(dirty.data(), n)) << "n = " << n;
+            EXPECT_EQ(expected_first, opex::simd::first_error_index(dirty.data(), n)) << "n = " << n;
+        }
+    }
+}
+
+TEST(Simd, SumOk)
+{
+    restore_isa restore;
+    const std::vector<std::size_t> errors = {2, 17, 40, 41, 42, 96};
+
+    for (auto isa : all_isas) {
+        if (!opex::simd::use(isa))
+            continue;
+
+        for (std::size_t n : {1, 7, 64, 99, 257}) {
+            const auto doubles = make_results<double>(n, errors);
+            const auto longs = make_results<std::int64_t>(n, errors);
+            const auto ints = make_results<int>(n, errors);
+
+            double expected = 0;
+            for (std::size_t i = 0; i < n; ++i)
+                if (doubles[i].is_ok())
+                    expected += doubles[i].unwrap();
+
+            EXPECT_EQ(expected, opex::simd::sum_ok(doubles.data(), n));
+            EXPECT_EQ(static_cast<std::int64_t>(expected), opex::simd::sum_ok(longs.data(), n));
+            EXPECT_EQ(static_cast<int>(expected), opex::simd::sum_ok(ints.data(), n));
+        }
+    }
+}
+
+TEST(Simd, Map)
+{
+    restore_isa restore;
+
+    for (auto isa : all_isas) {
+        if (!opex::simd::use(isa))
+            continue;
+
+        auto results = make_results<std::int64_t>(150, {1, 64, 149});
+        opex::simd::map(results.data(), results.size(), [](std::int64_t v) { return v * 10; });
+
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            if (i == 1 || i == 64 || i == 149)
+                EXPECT_EQ("bad field", results[i].what());
+            else
+                EXPECT_EQ(static_cast<std::int64_t>(i + 1) * 10, results[i].unwrap());
+        }
+    }
+}
+
+TEST(Simd, NonArithmeticValues)
+{
+    std::vector<gear::TestResult> results;
+    results.push_back(gear::TestResult{gear::TestType{}});
+    results.push_back(gear::TestResult::make_exception<gear::TestException>("no"));
+    results.push_back(gear::TestResult{gear::TestType{}});
+
+    EXPECT_EQ(2u, opex::simd::count_ok(results.data(), results.size()));
+    EXPECT_EQ(1u, opex::simd::first_error_index(results.data(), results.size()));
+
+    std::vector<opex::result<std::string>> strings;
+    strings.push_back(opex::result<std::string>{std::string{"a"}});
+    strings.push_back(opex::result<std::string>{std::string{"b"}});
+    opex::simd::map(strings.data(), strings.size(), [](const std::string &s) { return s + s; });
+
+    EXPECT_TRUE(opex::simd::all_ok(strings.data(), strings.size()));
+    EXPECT_EQ("aa", strings[0].unwrap());
+    EXPECT_EQ("bb", strings[1].unwrap());
+}
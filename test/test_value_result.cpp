@@ -0,0 +1,193 @@
+#include <expected>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+#include <opex/expected.h>
+
+#include "gear.h"
+
+namespace {
+    using exception_backend = opex::result<int, gear::TestException>;
+    using value_backend = opex::value_result<int, gear::TestException>;
+
+    // Runs a check against the default backend and the std::expected one, with the same error type.
+    template<typename Check>
+    void on_both_backends(Check check) {
+        {
+            SCOPED_TRACE("exception backend");
+            check(std::type_identity<exception_backend>{});
+        }
+        {
+            SCOPED_TRACE("value backend");
+            check(std::type_identity<value_backend>{});
+        }
+    }
+
+    template<typename R>
+    R parse(int i) {
+        if (i < 0)
+            return R::template make_exception<gear::TestException>("negative");
+        return R{i};
+    }
+
+    enum class code { bad_input = 1, overflow };
+    using code_result = opex::value_result<int, code>;
+
+    constexpr code_result half(int v) {
+        return v % 2 ? code_result::make_error(code::bad_input) : code_result{v / 2};
+    }
+}
+
+TEST(ValueResult, Accessors)
+{
+    on_both_backends([](auto backend) {
+        using R = typename decltype(backend)::type;
+        const auto ok = parse<R>(3);
+        const auto failed = parse<R>(-3);
+
+        EXPECT_TRUE(ok.is_ok());
+        EXPECT_TRUE(static_cast<bool>(ok));
+        EXPECT_EQ(3, ok.unwrap());
+        EXPECT_EQ(3, *ok);
+        EXPECT_EQ(std::string{}, ok.what());
+
+        EXPECT_TRUE(failed.is_err());
+        EXPECT_TRUE(!failed);
+        EXPECT_THROW(failed.unwrap(), gear::TestException);
+        EXPECT_EQ("negative", failed.what());
+        EXPECT_EQ("negative", failed.err_visit([](const gear::TestException &e) { return std::string{e.what()}; }));
+    });
+}
+
+TEST(ValueResult, Map)
+{
+    on_both_backends([](auto backend) {
+        using R = typename decltype(backend)::type;
+        const auto add = [](int i) { return i + 2; };
+
+        EXPECT_EQ(5, parse<R>(3).map(add).unwrap());
+        const auto ok = parse<R>(3);
+        EXPECT_EQ(5, ok.map(add).unwrap());
+
+        int calls = 0;
+        const auto failed = parse<R>(-3).map([&calls](int i) { ++calls; return i; });
+        EXPECT_EQ(0, calls);
+        EXPECT_EQ("negative", failed.what());
+    });
+}
+
+TEST(ValueResult, MapErr)
+{
+    on_both_backends([](auto backend) {
+        using R = typename decltype(backend)::type;
+        const auto to_logic = [](const gear::TestException &e) { return std::logic_error(e.what()); };
+
+        const auto ok = parse<R>(3).map_err(to_logic);
+        static_assert(std::is_same_v<std::logic_error, typename decltype(ok)::exception_type>);
+        EXPECT_EQ(3, ok.unwrap());
+
+        const auto failed = parse<R>(-3).map_err(to_logic);
+        EXPECT_THROW(failed.unwrap(), std::logic_error);
+        EXPECT_EQ("negative", failed.what());
+    });
+}
+
+TEST(ValueResult, AndThen)
+{
+    on_both_backends([](auto backend) {
+        using R = typename decltype(backend)::type;
+
+        EXPECT_EQ(4, parse<R>(3).and_then([](int i) { return parse<R>(i + 1); }).unwrap());
+        EXPECT_EQ("negative", parse<R>(3).and_then([](int i) { return parse<R>(-i); }).what());
+
+        int calls = 0;
+        const auto failed = parse<R>(-3);
+        EXPECT_TRUE(failed.and_then([&calls](int i) { ++calls; return parse<R>(i); }).is_err());
+        EXPECT_EQ(0, calls);
+    });
+}
+
+TEST(ValueResult, OrElse)
+{
+    on_both_backends([](auto backend) {
+        using R = typename decltype(backend)::type;
+
+        EXPECT_EQ(0, parse<R>(-3).or_else([](const gear::TestException &) { return R{0}; }).unwrap());
+
+        int calls = 0;
+        const auto ok = parse<R>(3);
+        EXPECT_EQ(3, ok.or_else([&calls](const gear::TestException &) { ++calls; return R{0}; }).unwrap());
+        EXPECT_EQ(0, calls);
+    });
+}
+
+TEST(ValueResult, Select)
+{
+    on_both_backends([](auto backend) {
+        using R = typename decltype(backend)::type;
+        const auto ok = parse<R>(1);
+        const auto other = parse<R>(2);
+        const auto failed = parse<R>(-1);
+
+        EXPECT_EQ(&other, &ok.and_select(other));
+        EXPECT_EQ(&failed, &failed.and_select(other));
+        EXPECT_EQ(&ok, &ok.or_select(other));
+        EXPECT_EQ(&other, &failed.or_select(other));
+
+        int calls = 0;
+        EXPECT_EQ(2, ok.and_select_with([&] { ++calls; return parse<R>(2); }).unwrap());
+        EXPECT_TRUE(failed.and_select_with([&] { ++calls; return parse<R>(2); }).is_err());
+        EXPECT_EQ(1, ok.or_select_with([&] { ++calls; return parse<R>(2); }).unwrap());
+        EXPECT_EQ(1, calls);
+    });
+}
+
+TEST(ValueResult, Call)
+{
+    on_both_backends([](auto backend) {
+        using R = typename decltype(backend)::type;
+
+        EXPECT_EQ(7, R::call([] { return 7; }).unwrap());
+        EXPECT_EQ("thrown", R::call([]() -> int { throw gear::TestException("thrown"); }).what());
+        EXPECT_THROW(R::call([]() -> int { throw std::out_of_range("other"); }), std::out_of_range);
+    });
+}
+
+TEST(ValueResult, ThinLayerOverExpected)
+{
+    static_assert(sizeof(code_result) == sizeof(std::expected<int, code>));
+    static_assert(std::is_trivially_copy_constructible_v<code_result>);
+    static_assert(std::is_trivially_destructible_v<code_result>);
+    static_assert(std::is_trivially_copyable_v<code_result> == std::is_trivially_copyable_v<std::expected<int, code>>);
+
+    static_assert(half(8).and_then(half).unwrap() == 2);
+    static_assert(half(6).and_then(half).error() == code::bad_input);
+    static_assert(half(4).map([](int v) { return v * 10; }).unwrap() == 20);
+    static_assert(half(3).or_else([](code) { return code_result{0}; }).unwrap() == 0);
+    static_assert(half(3).map_err([](code c) { return static_cast<int>(c); }).error() == 1);
+}
+
+TEST(ValueResult, ValueErrors)
+{
+    const auto failed = half(3);
+    EXPECT_EQ(code::bad_input, failed.error());
+    EXPECT_EQ(std::string{}, failed.what());
+    EXPECT_THROW(failed.unwrap(), std::bad_expected_access<code>);
+
+    const auto io = opex::value_result<int, std::error_code>::make_error(std::make_error_code(std::errc::io_error));
+    EXPECT_EQ(std::make_error_code(std::errc::io_error).message(), io.what());
+}
+
+TEST(ValueResult, ExpectedRoundTrip)
+{
+    auto e = opex::to_expected(half(8));
+    static_assert(std::is_same_v<std::expected<int, code>, decltype(e)>);
+    EXPECT_EQ(4, e.value());
+
+    const auto r = opex::from_expected(std::expected<int, code>{std::unexpect, code::overflow});
+    static_assert(std::is_same_v<const code_result, decltype(r)>);
+    EXPECT_EQ(code::overflow, r.error());
+}
@@ -0,0 +1,163 @@
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <opex/wire.h>
+
+#include "gear.h"
+
+namespace {
+    class HttpError : public std::runtime_error {
+    public:
+        HttpError(const std::string &message, int status):
+                std::runtime_error(message),
+                m_status(status)
+        {}
+
+        int status() const noexcept { return m_status; }
+
+    private:
+        int m_status;
+    };
+
+    opex::wire::error_registry<> make_registry() {
+        opex::wire::error_registry<> registry;
+        registry.add<gear::TestException>(1);
+        registry.add<HttpError>(2,
+                [](const HttpError &e, std::vector<unsigned char> &fields) {
+                    const auto status = e.status();
+                    fields.resize(sizeof(status));
+                    std::memcpy(fields.data(), &status, sizeof(status));
+                },
+                [](const opex::wire::view &v) {
+                    int status;
+                    std::memcpy(&status, v.fields_data(), sizeof(status));
+                    return HttpError{v.message(), status};
+                });
+        return registry;
+    }
+
+    struct Point {
+        int x, y;
+    };
+}
+
+TEST(Wire, Value)
+{
+    const auto registry = make_registry();
+    std::vector<unsigned char> buffer;
+    registry.encode(opex::result<Point>{Point{3, 4}}, buffer);
+
+    const opex::wire::view v{buffer.data(), buffer.size()};
+    ASSERT_TRUE(v.valid());
+    EXPECT_TRUE(v.is_ok());
+    EXPECT_EQ(buffer.size(), v.size());
+    EXPECT_EQ(4, v.value<Point>().y);
+
+    const auto decoded = registry.decode<Point>(v);
+    EXPECT_EQ(3, decoded.unwrap().x);
+}
+
+TEST(Wire, StringValue)
+{
+    const auto registry = make_registry();
+    std::vector<unsigned char> buffer;
+    registry.encode(opex::result<std::string>{std::string{"payload"}}, buffer);
+
+    const opex::wire::view v{buffer.data(), buffer.size()};
+    EXPECT_EQ("payload", std::string(reinterpret_cast<const char*>(v.value_data()), v.value_size()));
+    EXPECT_EQ("payload", registry.decode<std::string>(v).unwrap());
+}
+
+TEST(Wire, RegisteredError)
+{
+    const auto registry = make_registry();
+    std::vector<unsigned char> buffer;
+    registry.encode(opex::result<int>::make_exception<gear::TestException>("broken"), buffer);
+
+    const opex::wire::view v{buffer.data(), buffer.size()};
+    ASSERT_TRUE(v.is_err());
+    EXPECT_EQ(1u, v.type_id());
+    EXPECT_STREQ("broken", v.message());
+    EXPECT_GE(v.message(), reinterpret_cast<const char*>(buffer.data()));
+    EXPECT_LT(v.message(), reinterpret_cast<const char*>(buffer.data() + buffer.size()));
+
+    const auto decoded = registry.decode<int>(v);
+    EXPECT_EQ("broken", decoded.what());
+    EXPECT_THROW(decoded.unwrap(), gear::TestException);
+}
+
+TEST(Wire, ErrorFields)
+{
+    const auto registry = make_registry();
+    std::vector<unsigned char> buffer;
+    registry.encode(opex::result<int>::make_exception<HttpError>("not found", 404), buffer);
+
+    const auto decoded = registry.decode<int>(opex::wire::view{buffer.data(), buffer.size()});
+    decoded.err_visit([](const std::exception &e) {
+        const auto http = dynamic_cast<const HttpError*>(&e);
+        ASSERT_NE(nullptr, http);
+        EXPECT_EQ(404, http->status());
+        EXPECT_STREQ("not found", http->what());
+    });
+}
+
+TEST(Wire, UnregisteredError)
+{
+    const auto registry = make_registry();
+    std::vector<unsigned char> buffer;
+    registry.encode(opex::result<int>::make_exception<std::logic_error>("unknown"), buffer);
+
+    const opex::wire::view v{buffer.data(), buffer.size()};
+    EXPECT_EQ(0u, v.type_id());
+
+    const auto decoded = registry.decode<int>(v);
+    EXPECT_EQ("unknown", decoded.what());
+    EXPECT_THROW(decoded.unwrap(), opex::wire::remote_error);
+}
+
+TEST(Wire, Stream)
+{
+    const auto registry = make_registry();
+    std::vector<unsigned char> buffer;
+    registry.encode(opex::result<int>{1}, buffer);
+    registry.encode(opex::result<int>::make_exception<gear::TestException>("two"), buffer);
+    registry.encode(opex::result<int>{3}, buffer);
+
+    std::vector<std::string> seen;
+    for (std::size_t at = 0; at < buffer.size();) {
+        const opex::wire::view v{buffer.data() + at, buffer.size() - at};
+        ASSERT_TRUE(v.valid());
+        seen.push_back(v.is_ok() ? std::to_string(v.value<int>()) : v.message());
+        at += v.size();
+    }
+
+    EXPECT_EQ((std::vector<std::string>{"1", "two", "3"}), seen);
+}
+
+TEST(Wire, Malformed)
+{
+    const auto registry = make_registry();
+    std::vector<unsigned char> buffer;
+    registry.encode(opex::result<int>::make_exception<gear::TestException>("truncated"), buffer);
+
+    const opex::wire::view truncated{buffer.data(), buffer.size() - 1};
+    EXPECT_FALSE(truncated.valid());
+    EXPECT_FALSE(truncated.is_ok());
+    EXPECT_FALSE(truncated.is_err());
+    EXPECT_THROW(registry.decode<int>(truncated), opex::wire::decode_error);
+
+    buffer[0] = 'X';
+    EXPECT_FALSE((opex::wire::view{buffer.data(), buffer.size()}.valid()));
+}
+
+TEST(Wire, DuplicateIds)
+{
+    opex::wire::error_registry<> registry;
+    registry.add<gear::TestException>(1);
+
+    EXPECT_THROW(registry.add<std::runtime_error>(1), std::invalid_argument);
+    EXPECT_THROW(registry.add<std::runtime_error>(0), std::invalid_argument);
+}
@@ -0,0 +1,138 @@
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <opex/opex.h>
+#include <opex/zip.h>
+
+#include "gear.h"
+
+namespace {
+    using result_t = opex::result<int, gear::TestException>;
+    using string_result_t = opex::result<std::string, gear::TestException>;
+
+    struct Counted {
+        static int s_moves;
+        static int s_copies;
+
+        Counted() = default;
+        Counted(const Counted &) { ++s_copies; }
+        Counted(Counted &&) { ++s_moves; }
+    };
+
+    int Counted::s_moves = 0;
+    int Counted::s_copies = 0;
+
+    using counted_result_t = opex::result<Counted, gear::TestException>;
+
+    result_t fail(const char *message) {
+        return result_t::make_exception<gear::TestException>(message);
+    }
+}
+
+TEST(Zip, AllOk)
+{
+    const auto result = opex::zip(result_t{1}, string_result_t{"two"}, result_t{3});
+
+    static_assert(std::is_same<const opex::result<std::tuple<int, std::string, int>, gear::TestException>,
+                               decltype(result)>::value, "zip returns a result of a tuple");
+    ASSERT_TRUE(result.is_ok());
+    EXPECT_EQ(std::make_tuple(1, std::string{"two"}, 3), result.unwrap());
+}
+
+TEST(Zip, LeftmostErrorWins)
+{
+    const auto result = opex::zip(result_t{1}, fail("second"), fail("third"));
+
+    EXPECT_TRUE(result.is_err());
+    EXPECT_EQ("second", result.what());
+}
+
+TEST(Zip, KeepsContext)
+{
+    const auto result = opex::zip(fail("broken").context("loading ", 3), result_t{2});
+
+    EXPECT_EQ("loading 3: broken", result.what());
+}
+
+TEST(Zip, LvaluesAreCopied)
+{
+    const gear::TestResult first{gear::TestType{}};
+    gear::TestResult second{gear::TestType{}};
+
+    const auto result = opex::zip(first, second);
+
+    ASSERT_TRUE(result.is_ok());
+    EXPECT_TRUE(first.unwrap().valid());
+    EXPECT_TRUE(second.unwrap().valid());
+    EXPECT_EQ(first.unwrap(), std::get<0>(result.unwrap()));
+    EXPECT_EQ(second.unwrap(), std::get<1>(result.unwrap()));
+}
+
+TEST(Zip, MovesEachValueOnce)
+{
+    std::vector<counted_result_t> sources;
+    sources.emplace_back(Counted{});
+    sources.emplace_back(Counted{});
+    Counted::s_moves = 0;
+    Counted::s_copies = 0;
+
+    const auto result = opex::zip(std::move(sources[0]), std::move(sources[1]));
+
+    EXPECT_TRUE(result.is_ok());
+    EXPECT_EQ(2, Counted::s_moves);
+    EXPECT_EQ(0, Counted::s_copies);
+}
+
+TEST(Zip, MoveOnly)
+{
+    using ptr_result_t = opex::result<std::unique_ptr<int>, gear::TestException>;
+
+    auto result = opex::zip(ptr_result_t{std::unique_ptr<int>(new int(4))}, result_t{5});
+
+    ASSERT_TRUE(result.is_ok());
+    EXPECT_EQ(4, *std::get<0>(result.unwrap()));
+    EXPECT_EQ(5, std::get<1>(result.unwrap()));
+}
+
+TEST(Apply, AllOk)
+{
+    const auto result = opex::apply([](int a, const std::string &b, int c) { return a + int(b.size()) + c; },
+                                    result_t{1}, string_result_t{"two"}, result_t{3});
+
+    EXPECT_EQ(7, result.unwrap());
+}
+
+TEST(Apply, ErrorSkipsCall)
+{
+    int calls = 0;
+    const auto result = opex::apply([&calls](int a, int b) { ++calls; return a + b; },
+                                    fail("first"), fail("second"));
+
+    EXPECT_TRUE(result.is_err());
+    EXPECT_EQ("first", result.what());
+    EXPECT_EQ(0, calls);
+}
+
+TEST(Apply, ForwardsRvalues)
+{
+    using ptr_result_t = opex::result<std::unique_ptr<int>, gear::TestException>;
+
+    const auto result = opex::apply([](std::unique_ptr<int> p, int i) { return *p * i; },
+                                    ptr_result_t{std::unique_ptr<int>(new int(6))}, result_t{7});
+
+    EXPECT_EQ(42, result.unwrap());
+}
+
+TEST(Apply, Confined)
+{
+    using confined_t = opex::confined_result<int, gear::TestException>;
+
+    const auto result = opex::apply([](int a, int b) { return a * b; },
+                                    confined_t{2}, confined_t::make_exception<gear::TestException>("confined"));
+
+    EXPECT_EQ("confined", result.what());
+}